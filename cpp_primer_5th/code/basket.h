@@ -0,0 +1,163 @@
+#ifndef BASKET_H
+#define BASKET_H
+
+#include <bits/stdc++.h>
+#include "quote.h"
+#include "receipt_writer.h"
+
+class Basket {
+public:
+    // Basket uses synthesized default constructor and copy-control members
+    // each add_item adds qty copies of the given book
+    void add_item(const std::shared_ptr<Quote> &sale, std::size_t qty = 1);
+    // 新版本add_item负责内存分配; the quote is only copied the first time its ISBN is seen
+    void add_item(const Quote& sale, std::size_t qty = 1); // copy the given object
+    void add_item(Quote&& sale, std::size_t qty = 1); // move the given object
+    // take up to qty copies of the book out of the basket; returns how many were removed
+    std::size_t remove_item(const std::string &isbn, std::size_t qty = 1);
+
+    // overall total, kept up to date by add_item and remove_item
+    Money total() const { return running_total; }
+    // number of distinct books
+    std::size_t size() const { return items.size(); }
+    // calls f(quote, copies, net price) for each book, in the order they were first added
+    template <typename F> void for_each_line(F f) const {
+        for (auto &line : items)
+            f(*line.quote, line.qty, line.net);
+    }
+    // prints the total price for each book and the overall total for all items in the basket
+    Money total_receipt(std::ostream &) const;
+    // the same receipt formatted into w, in any of its formats; returns the total
+    Money write_receipt(ReceiptWriter &w) const;
+
+private:
+    // one line of the receipt: a book and how many copies of it were bought
+    struct Line {
+        std::shared_ptr<Quote> quote; // the first quote added for this ISBN prices the line
+        std::size_t qty;
+        Money net; // quote->net_price(qty), recomputed whenever qty changes
+    };
+    // the line for key, or nullptr if this book is not in the basket yet
+    Line *find_line(Isbn key) {
+        auto it = index.find(key);
+        return it == index.end() ? nullptr : &items[it->second];
+    }
+    void add_line(std::shared_ptr<Quote> quote, std::size_t qty) {
+        index.emplace(quote->isbn_key(), items.size());
+        order.emplace(quote.get(), items.size());
+        items.push_back({std::move(quote), 0, Money()});
+        set_qty(items.back(), qty);
+    }
+    // change the quantity of one line and fix up the total; repricing the whole line
+    // handles a quantity that crosses a discount threshold in either direction
+    void set_qty(Line &line, std::size_t qty) {
+        Money net = line.quote->net_price(qty);
+        running_total += net - line.net;
+        line.qty = qty;
+        line.net = net;
+    }
+
+    // one line per distinct book, in the order the books were first added
+    std::vector<Line> items;
+    // position in items of the line for each ISBN
+    std::unordered_map<Isbn, std::size_t> index;
+    // receipt order: by ISBN, and names that are not ISBNs by their text
+    struct ReceiptOrder {
+        bool operator()(const Quote *lhs, const Quote *rhs) const {
+            auto l = lhs->isbn_key(), r = rhs->isbn_key();
+            if (l.interned() && r.interned())
+                return lhs->isbn() < rhs->isbn();
+            return l < r;
+        }
+    };
+    // the same positions in receipt order, kept up to date as lines come and go, so a
+    // receipt is one pass; the quotes are shared by copies of the Basket, so the keys stay valid
+    std::map<const Quote*, std::size_t, ReceiptOrder> order;
+    Money running_total; // sum of the net prices of all lines, exact
+};
+
+inline void Basket::add_item(const std::shared_ptr<Quote> &sale, std::size_t qty)
+{
+    if (auto line = find_line(sale->isbn_key()))
+        set_qty(*line, line->qty + qty);
+    else
+        add_line(sale, qty);
+}
+
+inline void Basket::add_item(const Quote &sale, std::size_t qty)
+{
+    if (auto line = find_line(sale.isbn_key()))
+        set_qty(*line, line->qty + qty);
+    else
+        add_line(sale.clone_shared(), qty);
+}
+
+inline void Basket::add_item(Quote &&sale, std::size_t qty)
+{
+    if (auto line = find_line(sale.isbn_key()))
+        set_qty(*line, line->qty + qty);
+    else
+        add_line(std::move(sale).clone_shared(), qty);
+}
+
+inline std::size_t Basket::remove_item(const std::string &isbn, std::size_t qty)
+{
+    auto key = Isbn::find(isbn);
+    if (!key) // a book never quoted is not in any basket
+        return 0;
+    auto it = index.find(*key);
+    if (it == index.end())
+        return 0;
+    auto &line = items[it->second];
+    qty = std::min(qty, line.qty);
+    set_qty(line, line.qty - qty);
+    if (line.qty == 0) {
+        // drop the line: move the last line into its slot and update that line's index
+        auto pos = it->second;
+        index.erase(it);
+        order.erase(line.quote.get());
+        if (pos != items.size() - 1) {
+            items[pos] = std::move(items.back());
+            index[items[pos].quote->isbn_key()] = pos;
+            order[items[pos].quote.get()] = pos;
+        }
+        items.pop_back();
+    }
+    return qty;
+}
+
+// calculate and print the price for the given number of copies, applying any discounts
+inline Money print_total(std::ostream &os, const Quote &item, std::size_t n)
+{
+    // depending on the type of the object bound to the item parameter
+    // calls either Quote::net_price or Bulk_quote::net_price
+    Money ret = item.net_price(n);
+    // '\n' rather than endl: flushing after every line costs a write per line
+    os << "ISBN: " << item.isbn() // calls Quote::isbn
+       << " # sold: " << n << " total due: " << ret << '\n';
+    return ret;
+}
+
+inline Money Basket::write_receipt(ReceiptWriter &w) const
+{
+    Money sum; // holds the running total
+    // the receipt lists the books in ISBN order; each line already holds its count and price
+    for (auto &o : order) {
+        auto &line = items[o.second];
+        w.line(line.quote->isbn(), line.qty, line.net);
+        sum += line.net;
+    }
+    w.finish(sum); // the final overall total
+    return sum;
+}
+
+inline Money Basket::total_receipt(std::ostream &os) const
+{
+    // format the whole receipt first, then hand it to the stream in one write
+    static thread_local ReceiptWriter w; // reused, so its buffer is allocated once
+    Money sum = write_receipt(w);
+    w.write_to(os);
+    return sum;
+}
+
+#endif
@@ -0,0 +1,88 @@
+#include "basket_batch.h"
+
+using namespace std;
+
+// usage: basket_batch [baskets]; fills many baskets at yesterday's prices and reprices half
+// the catalog; then settles all baskets one total_receipt at a time as before, with
+// settle_baskets at the same prices, and with settle_baskets at today's catalog prices,
+// on pools of 1..hardware_concurrency threads
+
+const size_t nbooks = 20000;
+
+shared_ptr<Quote> make_book(size_t i, Money price)
+{
+    if (i % 2)
+        return make_shared<Bulk_quote>("book-" + to_string(i), price, 5 + i % 10, .15);
+    return make_shared<Quote>("book-" + to_string(i), price);
+}
+
+int main(int argc, char *argv[]) {
+    size_t n = argc > 1 ? stoul(argv[1]) : 500000;
+    vector<shared_ptr<Quote>> yesterday;
+    for (size_t i = 0; i != nbooks; ++i)
+        yesterday.push_back(make_book(i, Money::from_cents(500 + i * 37 % 9500)));
+    RcuCatalog prices({yesterday.begin(), yesterday.end()});
+
+    // a few popular books and a long tail; most baskets buy a copy or two of each
+    mt19937 gen(9);
+    vector<Basket> baskets(n);
+    vector<const Basket*> ptrs;
+    for (auto &b : baskets) {
+        for (size_t lines = 1 + gen() % 8; lines; --lines) {
+            size_t book = gen() % 4 ? gen() % 200 : gen() % nbooks;
+            b.add_item(yesterday[book], gen() % 3 ? 1 + gen() % 2 : 1 + gen() % 20);
+        }
+        ptrs.push_back(&b);
+    }
+    // today's prices for every other book, and one book that is no longer sold
+    vector<shared_ptr<const Quote>> changes;
+    for (size_t i = 0; i < nbooks; i += 2)
+        changes.push_back(make_book(i, Money::from_cents(450 + i * 37 % 9000)));
+    prices.update(changes, {Isbn("book-3")});
+
+    // what settle_baskets must produce, line by line
+    vector<Money> expected;
+    for (auto &b : baskets) {
+        Money sum;
+        b.for_each_line([&](const Quote &q, size_t qty, Money own) {
+            auto today = prices.net_price(q.isbn_key(), qty);
+            sum += today ? *today : own;
+        });
+        expected.push_back(sum);
+    }
+
+    auto start = chrono::steady_clock::now();
+    vector<Money> receipts;
+    for (auto &b : baskets) {
+        ostringstream receipt;
+        receipts.push_back(b.total_receipt(receipt));
+    }
+    chrono::duration<double, milli> old_ms = chrono::steady_clock::now() - start;
+    cout << n << " baskets, one total_receipt each: " << old_ms.count() << " ms, total "
+         << accumulate(receipts.begin(), receipts.end(), Money()) << endl;
+
+    unsigned max_threads = max(1u, thread::hardware_concurrency());
+    bool ok = true;
+    for (unsigned threads = 1; threads <= max_threads; threads *= 2) {
+        ThreadPool pool(threads);
+        // at the prices the baskets were filled at: must match the receipts
+        start = chrono::steady_clock::now();
+        auto totals = settle_baskets(ptrs, pool);
+        chrono::duration<double, milli> ms = chrono::steady_clock::now() - start;
+        ok = ok && totals == receipts;
+        cout << "settle_baskets, " << threads << " threads: " << ms.count() << " ms, total "
+             << accumulate(totals.begin(), totals.end(), Money())
+             << (totals == receipts ? "" : " (differs from total_receipt!)") << endl;
+
+        // at today's catalog prices
+        settle_baskets(ptrs, prices, pool); // warm up the heap
+        start = chrono::steady_clock::now();
+        totals = settle_baskets(ptrs, prices, pool);
+        ms = chrono::steady_clock::now() - start;
+        ok = ok && totals == expected;
+        cout << "settle_baskets at catalog prices, " << threads << " threads: " << ms.count()
+             << " ms, total " << accumulate(totals.begin(), totals.end(), Money())
+             << (totals == expected ? "" : " (differs from line-by-line pricing!)") << endl;
+    }
+    return ok ? 0 : 1;
+}
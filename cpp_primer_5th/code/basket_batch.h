@@ -0,0 +1,128 @@
+#ifndef BASKET_BATCH_H
+#define BASKET_BATCH_H
+
+#include <bits/stdc++.h>
+#include "basket.h"
+#include "rcu_catalog.h"
+#include "thread_pool.h"
+
+// helpers of settle_baskets
+namespace basket_batch {
+
+constexpr std::size_t shard_count = 256; // a power of two
+
+inline std::size_t shard_of(Isbn key)
+{
+    return (std::hash<Isbn>()(key) >> 16) & (shard_count - 1);
+}
+
+// a book and a number of copies: the unit that is priced once
+struct Tier {
+    Isbn key;
+    std::size_t qty;
+    bool operator==(const Tier &rhs) const { return key == rhs.key && qty == rhs.qty; }
+};
+
+struct TierHash {
+    std::size_t operator()(const Tier &t) const noexcept {
+        return std::hash<Isbn>()(t.key) ^ t.qty * 0x9e3779b97f4a7c15ULL;
+    }
+};
+
+}
+
+// end-of-day settlement: the totals of many baskets, the same amounts total_receipt gives,
+// with no stream output; each line already holds its net price (Basket reprices a line
+// whenever its quantity changes), so settling is a parallel sum over the baskets' lines
+inline std::vector<Money> settle_baskets(const std::vector<const Basket*> &baskets, ThreadPool &pool)
+{
+    const std::size_t nb = baskets.size(), pieces = std::min<std::size_t>(nb, 4 * (pool.size() + 1));
+    std::vector<Money> totals(nb);
+    pool.parallel_for(pieces, [&](std::size_t p) {
+        for (auto b = nb * p / pieces; b != nb * (p + 1) / pieces; ++b)
+            totals[b] = baskets[b]->total();
+    });
+    return totals;
+}
+
+// settlement at the catalog's current prices instead of the ones the baskets were filled at
+// the line items of all baskets are gathered into flat arrays and grouped by ISBN into
+// shards; each shard prices every distinct (book, copies) pair once, however many baskets
+// hold it, and the prices are scattered back and summed per basket. Every step runs on
+// the pool and nothing is written to a stream
+// all baskets are priced against one version of the catalog, so a price change that
+// happens meanwhile applies to all of them or to none; books the catalog does not list
+// keep the net price their basket already has
+inline std::vector<Money> settle_baskets(const std::vector<const Basket*> &baskets,
+                                         const RcuCatalog &prices, ThreadPool &pool)
+{
+    using namespace basket_batch;
+    // several pieces per thread, so that a piece with large baskets does not hold up the rest
+    const std::size_t nb = baskets.size(), pieces = std::min<std::size_t>(nb, 4 * (pool.size() + 1));
+    auto piece = [&](std::size_t p, std::size_t n) {
+        return std::make_pair(n * p / pieces, n * (p + 1) / pieces);
+    };
+
+    // gather: basket b owns slots [first[b], first[b + 1]) of the line arrays
+    std::vector<std::size_t> first(nb + 1, 0);
+    for (std::size_t b = 0; b != nb; ++b)
+        first[b + 1] = first[b] + baskets[b]->size();
+    const std::size_t nlines = first[nb];
+    std::vector<Tier> tiers(nlines);
+    std::vector<Money> net(nlines);
+    pool.parallel_for(pieces, [&](std::size_t p) {
+        auto r = piece(p, nb);
+        for (auto b = r.first; b != r.second; ++b) {
+            auto slot = first[b];
+            baskets[b]->for_each_line([&](const Quote &q, std::size_t qty, Money own) {
+                tiers[slot] = {q.isbn_key(), qty};
+                net[slot++] = own;
+            });
+        }
+    });
+
+    // merge: each piece sorts its slots into per-shard lists, so that one shard later
+    // sees every line for its books without scanning the others
+    std::vector<std::vector<std::vector<std::size_t>>> by_shard(pieces,
+            std::vector<std::vector<std::size_t>>(shard_count));
+    pool.parallel_for(pieces, [&](std::size_t p) {
+        auto r = piece(p, nlines);
+        for (auto slot = r.first; slot != r.second; ++slot)
+            by_shard[p][shard_of(tiers[slot].key)].push_back(slot);
+    });
+
+    // price: one catalog lookup per book and one net_price per (book, copies) in a shard;
+    // the catalog version stays alive while this thread is inside the read section
+    prices.read([&](const RcuCatalog::Version &v) {
+        pool.parallel_for(shard_count, [&](std::size_t s) {
+            std::unordered_map<Tier, Money, TierHash> priced;
+            std::unordered_map<Isbn, const Quote*> quotes; // nullptr: not in the catalog
+            for (std::size_t p = 0; p != pieces; ++p)
+                for (auto slot : by_shard[p][s]) {
+                    auto &t = tiers[slot];
+                    auto hit = priced.find(t);
+                    if (hit != priced.end()) {
+                        net[slot] = hit->second;
+                        continue;
+                    }
+                    auto q = quotes.emplace(t.key, nullptr);
+                    if (q.second)
+                        q.first->second = v.find(t.key);
+                    if (q.first->second)
+                        net[slot] = priced[t] = q.first->second->net_price(t.qty);
+                }
+        });
+        return 0;
+    });
+
+    // scatter: add up the lines of each basket
+    std::vector<Money> totals(nb);
+    pool.parallel_for(pieces, [&](std::size_t p) {
+        auto r = piece(p, nb);
+        for (auto b = r.first; b != r.second; ++b)
+            totals[b] = std::accumulate(net.begin() + first[b], net.begin() + first[b + 1], Money());
+    });
+    return totals;
+}
+
+#endif
@@ -0,0 +1,67 @@
+#include "basket.h"
+#include "bench.h"
+
+using namespace std;
+
+// usage: basket_bench [items]
+// times filling a Basket with randomly ordered quotes, printing its receipt, and
+// copying quotes with and without the pool
+
+// the quotes put into a basket: books with random ISBN-13s, each bought several times
+vector<shared_ptr<Quote>> make_sales(size_t n)
+{
+    mt19937 gen(7);
+    vector<shared_ptr<Quote>> books;
+    for (size_t i = 0; i != n / 8 + 1; ++i) {
+        books.push_back(make_shared<Bulk_quote>(make_isbn(gen()), Money(20 + i % 30), 5, .1));
+    }
+    vector<shared_ptr<Quote>> sales;
+    for (size_t i = 0; i != n; ++i)
+        sales.push_back(books[gen() % books.size()]);
+    return sales;
+}
+
+int main(int argc, char *argv[]) {
+    size_t n = argc > 1 ? stoul(argv[1]) : 1000000;
+    auto sales = make_sales(n);
+
+    // the original Basket: one multiset node per copy, isbn() copied and compared as strings
+    auto by_string = [](const shared_ptr<Quote> &lhs, const shared_ptr<Quote> &rhs) {
+        return string(lhs->isbn()) < string(rhs->isbn());
+    };
+    double before = ns_per(n, [&] {
+        multiset<shared_ptr<Quote>, decltype(by_string)> items(by_string);
+        for (auto &s : sales)
+            items.insert(s);
+    });
+    Basket b;
+    double after = ns_per(n, [&] {
+        for (auto &s : sales)
+            b.add_item(s);
+    });
+    ostringstream receipt;
+    double total = ns_per(n, [&] { b.total_receipt(receipt); });
+    cout << "insert, multiset of quotes: " << before << " ns/item" << endl;
+    cout << "insert, Basket line items: " << after << " ns/item" << endl;
+    cout << "total_receipt: " << total << " ns/item" << endl;
+
+    // copying quotes as add_item does for a new book: twice, so the pool is warm
+    vector<shared_ptr<Quote>> copies;
+    copies.reserve(n);
+    double plain = 0, pooled = 0;
+    for (int round = 0; round != 2; ++round) {
+        plain = ns_per(n, [&] {
+            for (auto &s : sales)
+                copies.push_back(shared_ptr<Quote>(s->clone()));
+            copies.clear();
+        });
+        pooled = ns_per(n, [&] {
+            for (auto &s : sales)
+                copies.push_back(s->clone_shared());
+            copies.clear();
+        });
+    }
+    cout << "clone + shared_ptr: " << plain << " ns/item" << endl;
+    cout << "pooled clone_shared: " << pooled << " ns/item" << endl;
+    return 0;
+}
@@ -0,0 +1,27 @@
+#ifndef BENCH_H
+#define BENCH_H
+
+#include <bits/stdc++.h>
+
+// helpers shared by the timing demos
+
+// a valid ISBN-13 made from n: 978, nine digits taken from n, and the check digit,
+// hyphenated as 978-123456789-7; n and n + 900000000 give the same ISBN
+inline std::string make_isbn(std::uint64_t n)
+{
+    std::string digits = "978" + std::to_string(100000000 + n % 900000000);
+    int sum = 0;
+    for (std::size_t i = 0; i != digits.size(); ++i)
+        sum += (digits[i] - '0') * (i % 2 ? 3 : 1);
+    return digits.substr(0, 3) + "-" + digits.substr(3) + "-" + std::to_string((10 - sum % 10) % 10);
+}
+
+// runs f once; returns the time it took in nanoseconds, divided by the n items it handled
+template <typename F> double ns_per(std::size_t n, F f)
+{
+    auto start = std::chrono::steady_clock::now();
+    f();
+    return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / n;
+}
+
+#endif
@@ -0,0 +1,48 @@
+#include "catalog.h"
+#include "basket.h"
+#include "bench.h"
+
+using namespace std;
+
+// usage: catalog [quotes]; writes a catalog of random books, loads it and times lookups
+
+int main(int argc, char *argv[]) {
+    size_t n = argc > 1 ? stoul(argv[1]) : 2000000;
+    {
+        ofstream out("catalog.csv");
+        out << "isbn,price,min_qty,discount\n";
+        for (size_t i = 0; i != n; ++i) {
+            out << make_isbn(i * 7919) << "," << 5 + i % 9500 / 100.0;
+            if (i % 3 == 0)
+                out << "," << 5 + i % 20 << "," << i % 40 / 100.0;
+            out << "\n";
+        }
+    }
+
+    auto start = chrono::steady_clock::now();
+    QuoteCatalog catalog("catalog.csv");
+    chrono::duration<double, milli> load = chrono::steady_clock::now() - start;
+    cout << catalog.size() << " quotes loaded in " << load.count() << " ms" << endl;
+
+    // random lookups, a third of them for books that are not in the catalog
+    mt19937 gen(5);
+    vector<Isbn> keys;
+    for (size_t i = 0; i != 1000000; ++i)
+        keys.push_back(Isbn(make_isbn(gen() % (3 * n / 2) * 7919)));
+    size_t found = 0;
+    start = chrono::steady_clock::now();
+    for (auto k : keys)
+        found += catalog.find(k) != QuoteCatalog::npos;
+    chrono::duration<double, nano> lookups = chrono::steady_clock::now() - start;
+    cout << "lookup: " << lookups.count() / keys.size() << " ns, " << found << " hits" << endl;
+
+    // baskets share the catalog's Quote objects instead of cloning their own
+    Basket b;
+    auto id = catalog.find(make_isbn(3 * 7919));
+    b.add_item(catalog.quote(id), 10);
+    b.add_item(catalog.quote(catalog.find(make_isbn(4 * 7919))), 2);
+    b.total_receipt(cout);
+    cout << "catalog price of line 1: " << catalog.net_price(id, 10) << endl;
+    remove("catalog.csv");
+    return 0;
+}
@@ -0,0 +1,221 @@
+#ifndef CATALOG_H
+#define CATALOG_H
+
+#include <bits/stdc++.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "isbn_table.h"
+#include "quote.h"
+
+// price catalog loaded from a CSV file, one quote per line:
+//   isbn,price                         a Quote
+//   isbn,price,min_qty,discount        a Bulk_quote
+// an optional first line starting with "isbn," is a header and is skipped
+// the file is mapped and parsed by several threads at once; entries are kept as compact
+// records indexed by packed ISBN in an open-addressing hash table, and are identified by
+// their position (an Id). Quote objects are only built on demand, once per entry, and
+// are shared by every Basket that refers to the entry
+class QuoteCatalog {
+public:
+    using Id = std::uint32_t;
+    static constexpr Id npos = std::numeric_limits<Id>::max();
+
+    QuoteCatalog() = default;
+    explicit QuoteCatalog(const std::string &path, unsigned threads = 0); // 0: one per core
+    QuoteCatalog(const QuoteCatalog&) = delete;
+    QuoteCatalog &operator=(const QuoteCatalog&) = delete;
+
+    std::size_t size() const { return entries.size(); }
+    // the entry for key, or npos; when an ISBN appears more than once, the first line wins
+    Id find(Isbn key) const;
+    Id find(std::string_view isbn) const {
+        auto key = Isbn::find(isbn);
+        return key ? find(*key) : npos;
+    }
+
+    std::string_view isbn(Id id) const {
+        return {chars.data() + entries[id].isbn_off, entries[id].isbn_len};
+    }
+    // same result as quote(id)->net_price(n), without building the Quote
+    Money net_price(Id id, std::size_t n) const {
+        auto &e = entries[id];
+        return n >= e.min_qty ? discounted(n * e.price, e.discount) : n * e.price;
+    }
+    // the entry as a Quote or Bulk_quote, built on first use and shared afterwards;
+    // pass it to Basket::add_item(shared_ptr) so the basket does not copy it
+    std::shared_ptr<Quote> quote(Id id) const;
+private:
+    struct Entry {
+        Isbn key;
+        Money price;
+        Discount discount; // 0 for a plain Quote
+        std::size_t min_qty; // npos (never reached) for a plain Quote
+        std::uint32_t isbn_off, isbn_len; // the ISBN text in chars
+    };
+    // one thread's share of the file
+    struct Part {
+        std::vector<Entry> entries;
+        std::string chars;
+    };
+    static void parse(const char *b, const char *e, Part &out);
+    void build_index();
+
+    std::vector<Entry> entries;
+    std::string chars; // text of all ISBNs, back to back
+    IsbnTable<Id> index; // entry of each ISBN
+    mutable std::unique_ptr<std::shared_ptr<Quote>[]> quotes; // built by quote()
+};
+
+inline void QuoteCatalog::parse(const char *b, const char *e, Part &out)
+{
+    auto bad = [e](const char *p) {
+        return std::runtime_error("bad catalog line \"" + std::string(p, std::find(p, e, '\n')) + "\"");
+    };
+    while (b < e) {
+        auto eol = std::find(b, e, '\n');
+        auto line = b;
+        b = eol == e ? e : eol + 1;
+        auto end = eol != line && eol[-1] == '\r' ? eol - 1 : eol;
+        if (line == end)
+            continue; // blank line
+        auto comma = std::find(line, end, ',');
+        if (comma == end)
+            throw bad(line);
+        Entry ent{Isbn(std::string_view(line, comma - line)), Money(), Discount(),
+                  std::numeric_limits<std::size_t>::max(),
+                  static_cast<std::uint32_t>(out.chars.size()),
+                  static_cast<std::uint32_t>(comma - line)};
+        if (ent.key == Isbn())
+            throw bad(line);
+        auto p = comma + 1;
+        auto r = from_chars(p, end, ent.price); // exact to the cent, see money.h
+        if (r.ec != std::errc())
+            throw bad(line);
+        p = r.ptr;
+        if (p != end) {
+            // bulk fields
+            if (*p++ != ',')
+                throw bad(line);
+            auto q = std::from_chars(p, end, ent.min_qty);
+            if (q.ec != std::errc() || q.ptr == end || *q.ptr != ',')
+                throw bad(line);
+            double rate;
+            q = std::from_chars(q.ptr + 1, end, rate);
+            if (q.ec != std::errc() || q.ptr != end)
+                throw bad(line);
+            ent.discount = rate;
+        }
+        out.chars.append(line, comma);
+        out.entries.push_back(ent);
+    }
+}
+
+inline QuoteCatalog::QuoteCatalog(const std::string &path, unsigned threads)
+{
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0)
+        throw std::runtime_error("cannot open " + path);
+    struct stat st;
+    if (fstat(fd, &st) < 0) {
+        close(fd);
+        throw std::runtime_error("cannot stat " + path);
+    }
+    std::size_t len = st.st_size;
+    void *map = len ? mmap(nullptr, len, PROT_READ, MAP_PRIVATE, fd, 0) : nullptr;
+    close(fd);
+    if (map == MAP_FAILED)
+        throw std::runtime_error("mmap failed: " + path);
+    auto text = static_cast<const char*>(map), end = text + len;
+    madvise(map, len, MADV_SEQUENTIAL);
+
+    const char *begin = text;
+    if (len >= 5 && std::memcmp(text, "isbn,", 5) == 0) { // skip the header
+        begin = std::find(text, end, '\n');
+        begin = begin == end ? end : begin + 1;
+    }
+
+    // cut the file into one piece per thread, each starting at the beginning of a line
+    if (threads == 0)
+        threads = std::max(1u, std::thread::hardware_concurrency());
+    std::vector<const char*> cuts{begin};
+    for (unsigned t = 1; t < threads; ++t) {
+        auto p = std::max(cuts.back(), begin + (end - begin) * t / threads);
+        auto eol = std::find(p, end, '\n');
+        cuts.push_back(eol == end ? end : eol + 1);
+    }
+    cuts.push_back(end);
+
+    std::vector<Part> parts(threads);
+    std::vector<std::exception_ptr> errors(threads);
+    std::vector<std::thread> workers;
+    for (unsigned t = 0; t != threads; ++t)
+        workers.emplace_back([&, t] {
+            try {
+                parse(cuts[t], std::max(cuts[t], cuts[t + 1]), parts[t]);
+            } catch (...) {
+                errors[t] = std::current_exception();
+            }
+        });
+    for (auto &w : workers)
+        w.join();
+    if (map)
+        munmap(map, len);
+    for (auto &e : errors)
+        if (e)
+            std::rethrow_exception(e);
+
+    // concatenate the parts in file order, so ids follow the lines of the file
+    std::size_t n = 0, nchars = 0;
+    for (auto &p : parts) {
+        n += p.entries.size();
+        nchars += p.chars.size();
+    }
+    if (n >= npos || nchars > std::numeric_limits<std::uint32_t>::max())
+        throw std::runtime_error("catalog too large: " + path);
+    entries.reserve(n);
+    chars.reserve(nchars);
+    for (auto &p : parts) {
+        auto base = static_cast<std::uint32_t>(chars.size());
+        for (auto &e : p.entries) {
+            entries.push_back(e);
+            entries.back().isbn_off += base;
+        }
+        chars += p.chars;
+    }
+    build_index();
+    quotes.reset(new std::shared_ptr<Quote>[entries.size()]);
+}
+
+inline void QuoteCatalog::build_index()
+{
+    index.reserve(entries.size());
+    for (Id id = 0; id != entries.size(); ++id)
+        index.insert(entries[id].key, id); // a duplicate keeps the earlier line
+}
+
+inline QuoteCatalog::Id QuoteCatalog::find(Isbn key) const
+{
+    auto id = index.find(key);
+    return id ? *id : npos;
+}
+
+inline std::shared_ptr<Quote> QuoteCatalog::quote(Id id) const
+{
+    auto &slot = quotes[id];
+    if (auto q = std::atomic_load(&slot))
+        return q;
+    auto &e = entries[id];
+    std::string book(isbn(id));
+    std::shared_ptr<Quote> q = e.discount == Discount() && e.min_qty == std::numeric_limits<std::size_t>::max()
+        ? std::make_shared<Quote>(book, e.price)
+        : std::make_shared<Bulk_quote>(book, e.price, e.min_qty, e.discount);
+    // if another thread got there first, use its object so that the entry has only one
+    std::shared_ptr<Quote> expected;
+    if (!std::atomic_compare_exchange_strong(&slot, &expected, q))
+        return expected;
+    return q;
+}
+
+#endif
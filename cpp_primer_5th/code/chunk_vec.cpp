@@ -0,0 +1,39 @@
+#include "chunk_vec.h"
+
+using namespace std;
+
+// slowest single push_back while appending n strings
+template <typename C> chrono::nanoseconds worst_push(C &c, size_t n)
+{
+    chrono::nanoseconds worst{0};
+    for (size_t i = 0; i != n; ++i) {
+        auto start = chrono::steady_clock::now();
+        c.push_back("symbol_" + to_string(i));
+        worst = max(worst, chrono::steady_clock::now() - start);
+    }
+    return worst;
+}
+
+int main() {
+    StrChunkVec cv;
+    for (auto s : {"abc", "def", "ghi"})
+        cv.push_back(s);
+    for (auto &s : cv)
+        cout << s << " ";
+    cout << cv[1] << endl;
+
+    const size_t n = 10000000;
+    StrVec sv;
+    StrChunkVec chunked;
+    cout << "StrVec worst push_back: " << worst_push(sv, n).count() / 1000 << " us" << endl;
+    cout << "StrChunkVec worst push_back: " << worst_push(chunked, n).count() / 1000 << " us" << endl;
+
+    // consumers can walk the storage one contiguous chunk at a time
+    size_t total = 0;
+    for (size_t c = 0; c != chunked.chunk_count(); ++c)
+        for (auto &s : chunked.chunk(c))
+            total += s.size();
+    cout << chunked.size() << " strings in " << chunked.chunk_count() << " chunks, "
+         << total << " characters" << endl;
+    return 0;
+}
@@ -0,0 +1,149 @@
+#ifndef CHUNK_VEC_H
+#define CHUNK_VEC_H
+
+#include <bits/stdc++.h>
+#include "vec.h"
+
+// vector-like container for streams of unknown length
+// elements live in fixed-size chunks that never move; a small index of chunk pointers
+// gives random access, so push_back never relocates elements and costs at most one
+// chunk allocation. Only the index (one pointer per ChunkSize elements) still grows by
+// doubling
+template <typename T, std::size_t ChunkSize = 4096> class ChunkVec {
+    static_assert(ChunkSize && (ChunkSize & (ChunkSize - 1)) == 0,
+                  "ChunkSize must be a power of two");
+public:
+    using value_type = T;
+    using size_type = std::size_t;
+
+    // contiguous run of elements, for consumers that want to process whole arrays
+    struct Chunk {
+        T *data;
+        size_type size;
+        T *begin() const { return data; }
+        T *end() const { return data + size; }
+    };
+
+    template <typename V> class basic_iterator {
+    public:
+        using iterator_category = std::random_access_iterator_tag;
+        using value_type = T;
+        using difference_type = std::ptrdiff_t;
+        using pointer = V*;
+        using reference = V&;
+
+        basic_iterator(T *const *c, size_type i): chunks(c), idx(i) { }
+        V &operator*() const { return chunks[idx / ChunkSize][idx % ChunkSize]; }
+        V *operator->() const { return &**this; }
+        V &operator[](difference_type n) const { return *(*this + n); }
+        basic_iterator &operator++() { ++idx; return *this; }
+        basic_iterator operator++(int) { auto ret = *this; ++idx; return ret; }
+        basic_iterator &operator--() { --idx; return *this; }
+        basic_iterator operator--(int) { auto ret = *this; --idx; return ret; }
+        basic_iterator &operator+=(difference_type n) { idx += n; return *this; }
+        basic_iterator &operator-=(difference_type n) { idx -= n; return *this; }
+        basic_iterator operator+(difference_type n) const { return {chunks, idx + n}; }
+        basic_iterator operator-(difference_type n) const { return {chunks, idx - n}; }
+        difference_type operator-(const basic_iterator &rhs) const { return idx - rhs.idx; }
+        bool operator==(const basic_iterator &rhs) const { return idx == rhs.idx; }
+        bool operator!=(const basic_iterator &rhs) const { return idx != rhs.idx; }
+        bool operator<(const basic_iterator &rhs) const { return idx < rhs.idx; }
+    private:
+        T *const *chunks;
+        size_type idx;
+    };
+    using iterator = basic_iterator<T>;
+    using const_iterator = basic_iterator<const T>;
+
+    ChunkVec() = default;
+    ChunkVec(const ChunkVec&); // copy constructor
+    ChunkVec(ChunkVec &&c) noexcept: chunks(std::move(c.chunks)), n(c.n) { c.n = 0; }
+    ChunkVec &operator=(ChunkVec); // copy and move assignment through swap
+    ~ChunkVec() { free(); }
+    friend void swap(ChunkVec &lhs, ChunkVec &rhs) noexcept {
+        std::swap(lhs.chunks, rhs.chunks);
+        std::swap(lhs.n, rhs.n);
+    }
+
+    void push_back(const T &t) { emplace_back(t); }
+    void push_back(T &&t) { emplace_back(std::move(t)); }
+    template <typename... Args> T &emplace_back(Args&&... args);
+    void pop_back();
+
+    size_type size() const { return n; }
+    bool empty() const { return n == 0; }
+    T &operator[](size_type i) { return chunks[i / ChunkSize][i % ChunkSize]; }
+    const T &operator[](size_type i) const { return chunks[i / ChunkSize][i % ChunkSize]; }
+    iterator begin() { return {chunks.begin(), 0}; }
+    iterator end() { return {chunks.begin(), n}; }
+    const_iterator begin() const { return {chunks.begin(), 0}; }
+    const_iterator end() const { return {chunks.begin(), n}; }
+
+    // the elements as a sequence of contiguous chunks; only the last may be partly filled
+    size_type chunk_count() const { return (n + ChunkSize - 1) / ChunkSize; }
+    Chunk chunk(size_type c) const {
+        return {chunks[c], std::min(ChunkSize, n - c * ChunkSize)};
+    }
+private:
+    void free(); // destroy the elements and give back every chunk
+
+    std::allocator<T> alloc; // allocates the chunks
+    Vec<T*> chunks; // chunk c holds elements [c * ChunkSize, (c + 1) * ChunkSize)
+    size_type n = 0; // number of elements
+};
+
+template <typename T, std::size_t ChunkSize>
+template <typename... Args>
+T &ChunkVec<T, ChunkSize>::emplace_back(Args&&... args)
+{
+    // chunks are kept after pop_back, so only a completely new chunk needs memory
+    if (n / ChunkSize == chunks.size())
+        chunks.push_back(alloc.allocate(ChunkSize));
+    auto p = chunks[n / ChunkSize] + n % ChunkSize;
+    std::allocator_traits<std::allocator<T>>::construct(alloc, p, std::forward<Args>(args)...);
+    ++n;
+    return *p;
+}
+
+template <typename T, std::size_t ChunkSize>
+void ChunkVec<T, ChunkSize>::pop_back()
+{
+    --n;
+    std::allocator_traits<std::allocator<T>>::destroy(alloc, &(*this)[n]);
+}
+
+template <typename T, std::size_t ChunkSize>
+void ChunkVec<T, ChunkSize>::free()
+{
+    // destroy the elements in reverse order, then free all chunks, including spare ones
+    while (n)
+        pop_back();
+    for (auto c : chunks)
+        alloc.deallocate(c, ChunkSize);
+    chunks = Vec<T*>();
+}
+
+template <typename T, std::size_t ChunkSize>
+ChunkVec<T, ChunkSize>::ChunkVec(const ChunkVec &c)
+{
+    // if a copy throws, the destructor of this partly built object will not run
+    try {
+        for (auto &t : c)
+            push_back(t);
+    } catch (...) {
+        free();
+        throw;
+    }
+}
+
+template <typename T, std::size_t ChunkSize>
+ChunkVec<T, ChunkSize> &ChunkVec<T, ChunkSize>::operator=(ChunkVec rhs)
+{
+    swap(*this, rhs); // rhs now holds our old chunks and frees them
+    return *this;
+}
+
+// chunked counterpart of StrVec
+using StrChunkVec = ChunkVec<std::string>;
+
+#endif
@@ -0,0 +1,46 @@
+#include "concurrent_basket.h"
+
+using namespace std;
+
+// usage: concurrent_basket [items]; fills one basket from 1..hardware_concurrency threads,
+// first through a single mutex-guarded Basket, then through a ConcurrentBasket
+
+template <typename Add> double adds_per_second(unsigned threads, size_t items, Add add)
+{
+    auto start = chrono::steady_clock::now();
+    vector<thread> workers;
+    for (unsigned t = 0; t != threads; ++t)
+        workers.emplace_back([=, &add] {
+            for (size_t i = t; i < items; i += threads)
+                add(i);
+        });
+    for (auto &w : workers)
+        w.join();
+    return items / chrono::duration<double>(chrono::steady_clock::now() - start).count();
+}
+
+int main(int argc, char *argv[]) {
+    size_t items = argc > 1 ? stoul(argv[1]) : 4000000;
+    vector<shared_ptr<Quote>> books;
+    for (int i = 0; i != 5000; ++i)
+        books.push_back(make_shared<Bulk_quote>("book-" + to_string(i), Money(10 + i % 40), 20, .1));
+
+    unsigned max_threads = max(1u, thread::hardware_concurrency());
+    for (unsigned threads = 1; threads <= max_threads; threads *= 2) {
+        Basket locked;
+        mutex m;
+        double a = adds_per_second(threads, items, [&](size_t i) {
+            lock_guard<mutex> lock(m);
+            locked.add_item(books[i % books.size()]);
+        });
+        ConcurrentBasket sharded;
+        double b = adds_per_second(threads, items, [&](size_t i) {
+            sharded.add_item(books[i % books.size()]);
+        });
+        ostringstream r1, r2;
+        bool same = locked.total_receipt(r1) == sharded.total_receipt(r2) && r1.str() == r2.str();
+        cout << threads << " threads: mutex " << a / 1e6 << " M adds/s, sharded "
+             << b / 1e6 << " M adds/s" << (same ? "" : " (receipts differ!)") << endl;
+    }
+    return 0;
+}
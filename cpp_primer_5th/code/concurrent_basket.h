@@ -0,0 +1,90 @@
+#ifndef CONCURRENT_BASKET_H
+#define CONCURRENT_BASKET_H
+
+#include <bits/stdc++.h>
+#include "basket.h"
+
+// Basket that many threads can fill at once
+// books are spread over shards by ISBN; adding to a book already in the basket takes a
+// shared lock on its shard and bumps an atomic counter, and only the first add of a book
+// takes the shard's exclusive lock. Adds to books in different shards touch different
+// cache lines; adds to the same book, or to books in one shard, still meet on the shard's
+// lock word and the line's counter, so a popular book is a point of contention.
+// snapshot() locks every shard, so it sees all adds that finished before it
+class ConcurrentBasket {
+public:
+    void add_item(const std::shared_ptr<Quote> &sale, std::size_t qty = 1);
+    void add_item(const Quote &sale, std::size_t qty = 1);
+
+    // an ordinary Basket holding the lines at one instant
+    Basket snapshot() const;
+    Money total_receipt(std::ostream &os) const { return snapshot().total_receipt(os); }
+private:
+    static constexpr std::size_t shard_count = 64;
+
+    struct Line {
+        explicit Line(std::shared_ptr<Quote> q): quote(std::move(q)) { }
+        std::shared_ptr<Quote> quote;
+        std::atomic<std::size_t> qty{0};
+    };
+    // each shard on its own cache lines, so locking one does not slow its neighbours
+    struct alignas(64) Shard {
+        mutable std::shared_mutex m;
+        std::unordered_map<Isbn, Line> lines; // nodes never move, so Line can hold an atomic
+    };
+
+    Shard &shard(Isbn key) { return shards[std::hash<Isbn>()(key) % shard_count]; }
+    // add to the line for key; make() supplies the quote if the line has to be created
+    template <typename Make> void add(Isbn key, std::size_t qty, Make make);
+
+    std::array<Shard, shard_count> shards;
+};
+
+template <typename Make>
+void ConcurrentBasket::add(Isbn key, std::size_t qty, Make make)
+{
+    auto &s = shard(key);
+    {
+        std::shared_lock<std::shared_mutex> lock(s.m);
+        auto it = s.lines.find(key);
+        if (it != s.lines.end()) {
+            it->second.qty.fetch_add(qty, std::memory_order_relaxed);
+            return;
+        }
+    }
+    // copy the quote outside the lock; if another thread wins the race it is dropped
+    auto quote = make();
+    std::unique_lock<std::shared_mutex> lock(s.m);
+    auto it = s.lines.try_emplace(key, std::move(quote)).first;
+    it->second.qty.fetch_add(qty, std::memory_order_relaxed);
+}
+
+inline void ConcurrentBasket::add_item(const std::shared_ptr<Quote> &sale, std::size_t qty)
+{
+    add(sale->isbn_key(), qty, [&] { return sale; });
+}
+
+inline void ConcurrentBasket::add_item(const Quote &sale, std::size_t qty)
+{
+    add(sale.isbn_key(), qty, [&] { return sale.clone_shared(); });
+}
+
+inline Basket ConcurrentBasket::snapshot() const
+{
+    // hold every shard at once, always in the same order, so the copy is consistent
+    std::vector<std::unique_lock<std::shared_mutex>> locks;
+    locks.reserve(shard_count);
+    for (auto &s : shards)
+        locks.emplace_back(s.m);
+    std::vector<std::pair<std::shared_ptr<Quote>, std::size_t>> lines;
+    for (auto &s : shards)
+        for (auto &l : s.lines)
+            lines.emplace_back(l.second.quote, l.second.qty.load(std::memory_order_relaxed));
+    locks.clear(); // build the Basket without blocking the writers
+    Basket ret;
+    for (auto &l : lines)
+        ret.add_item(l.first, l.second);
+    return ret;
+}
+
+#endif
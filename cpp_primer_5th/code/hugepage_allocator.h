@@ -0,0 +1,97 @@
+#ifndef HUGEPAGE_ALLOCATOR_H
+#define HUGEPAGE_ALLOCATOR_H
+
+#include <bits/stdc++.h>
+#include <sys/mman.h>
+
+constexpr std::size_t huge_page_size = std::size_t(1) << 21; // 2 MB on x86-64
+
+// allocator for very large arrays
+// blocks of at least Threshold bytes are mapped directly and backed by 2 MB pages:
+// first from the hugetlbfs pool (MAP_HUGETLB), otherwise as ordinary anonymous memory
+// marked for transparent huge pages (MADV_HUGEPAGE); smaller blocks use operator new
+// whether a block was mapped depends only on its size, so deallocate can tell them apart
+template <typename T, std::size_t Threshold = (std::size_t(32) << 20)>
+class HugePageAllocator {
+public:
+    using value_type = T;
+    template <typename U> struct rebind { using other = HugePageAllocator<U, Threshold>; };
+
+    HugePageAllocator() = default;
+    template <typename U>
+    HugePageAllocator(const HugePageAllocator<U, Threshold>&) noexcept { }
+
+    T *allocate(std::size_t n);
+    void deallocate(T *p, std::size_t n) noexcept;
+    // grow a mapped block to new_n elements with mremap, keeping its contents;
+    // returns nullptr when that is not possible and the caller must copy instead
+    // the bytes are moved as they are, so only use this for trivially copyable T
+    T *reallocate(T *p, std::size_t old_n, std::size_t new_n) noexcept;
+
+    friend bool operator==(const HugePageAllocator&, const HugePageAllocator&) { return true; }
+    friend bool operator!=(const HugePageAllocator&, const HugePageAllocator&) { return false; }
+private:
+    static bool mapped(std::size_t n) { return n * sizeof(T) >= Threshold; }
+    // mappings are whole huge pages so that hugetlb mappings can be unmapped and resized
+    static std::size_t map_length(std::size_t n) {
+        return (n * sizeof(T) + huge_page_size - 1) & ~(huge_page_size - 1);
+    }
+};
+
+template <typename T, std::size_t Threshold>
+T *HugePageAllocator<T, Threshold>::allocate(std::size_t n)
+{
+    if (n > std::numeric_limits<std::size_t>::max() / sizeof(T))
+        throw std::bad_array_new_length();
+    if (!mapped(n))
+        return static_cast<T*>(::operator new(n * sizeof(T)));
+    auto len = map_length(n);
+    void *p = MAP_FAILED;
+#ifdef MAP_HUGETLB
+    // only succeeds if the administrator reserved huge pages (vm.nr_hugepages)
+    p = mmap(nullptr, len, PROT_READ | PROT_WRITE,
+             MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+#endif
+    if (p == MAP_FAILED) {
+        p = mmap(nullptr, len, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (p == MAP_FAILED)
+            throw std::bad_alloc();
+#ifdef MADV_HUGEPAGE
+        // a hint only; without THP support we simply keep 4 KB pages
+        madvise(p, len, MADV_HUGEPAGE);
+#endif
+    }
+    return static_cast<T*>(p);
+}
+
+template <typename T, std::size_t Threshold>
+void HugePageAllocator<T, Threshold>::deallocate(T *p, std::size_t n) noexcept
+{
+    if (mapped(n))
+        munmap(p, map_length(n));
+    else
+        ::operator delete(p);
+}
+
+template <typename T, std::size_t Threshold>
+T *HugePageAllocator<T, Threshold>::reallocate(T *p, std::size_t old_n, std::size_t new_n) noexcept
+{
+#ifdef MREMAP_MAYMOVE
+    // a small block lives on the heap and cannot be remapped
+    if (!mapped(old_n) || !mapped(new_n))
+        return nullptr;
+    // the kernel moves the page table entries; no element is copied
+    void *q = mremap(p, map_length(old_n), map_length(new_n), MREMAP_MAYMOVE);
+    if (q == MAP_FAILED)
+        return nullptr; // e.g. hugetlb mappings on older kernels
+#ifdef MADV_HUGEPAGE
+    madvise(q, map_length(new_n), MADV_HUGEPAGE);
+#endif
+    return static_cast<T*>(q);
+#else
+    (void)p; (void)old_n; (void)new_n;
+    return nullptr;
+#endif
+}
+
+#endif
@@ -0,0 +1,38 @@
+#include "vec.h"
+#include "hugepage_allocator.h"
+
+using namespace std;
+
+// kilobytes of this process's memory that are backed by transparent huge pages
+long anon_huge_kb()
+{
+    ifstream in("/proc/self/smaps_rollup");
+    string line;
+    while (getline(in, line))
+        if (line.compare(0, 14, "AnonHugePages:") == 0)
+            return stol(line.substr(14));
+    return -1;
+}
+
+int main() {
+    // once the array passes 32 MB it is mapped with 2 MB pages and grows with mremap
+    Vec<long, HugePageAllocator<long>> big;
+    auto start = chrono::steady_clock::now();
+    for (long i = 0; i != 64L << 20; ++i)
+        big.push_back(i);
+    auto ms = chrono::duration_cast<chrono::milliseconds>(chrono::steady_clock::now() - start);
+    long sum = 0;
+    for (auto v : big)
+        sum += v;
+    cout << big.size() << " elements, " << big.capacity() * sizeof(long) / (1 << 20)
+         << " MB in " << ms.count() << " ms, sum " << sum << endl;
+    cout << "AnonHugePages: " << anon_huge_kb() << " kB" << endl;
+
+    // strings are not trivially copyable: the array is still huge-page backed,
+    // but growing it moves the elements as usual
+    Vec<string, HugePageAllocator<string>> names;
+    for (int i = 0; i != 1 << 21; ++i)
+        names.push_back(to_string(i));
+    cout << names.size() << " " << names[12345] << endl;
+    return 0;
+}
@@ -0,0 +1,143 @@
+#ifndef ISBN_H
+#define ISBN_H
+
+#include <bits/stdc++.h>
+
+// compact key for an ISBN, so that ordering and lookup are integer compares
+// ISBN-10 and ISBN-13 strings (with or without hyphens) are packed as the 13-digit
+// number, so both spellings of a book get the same key and keys order like the digits;
+// anything else is interned and gets a sequence number, ordered after all real ISBNs;
+// interned keys order among themselves by when they were first seen, so code that lists
+// them in text order compares the strings (see Basket::write_receipt)
+class Isbn {
+public:
+    Isbn() = default; // the empty ISBN, ordered first
+    explicit Isbn(std::string_view);
+    // the key of s without interning it, or nothing for a name no key was built from yet;
+    // lookups use this so that misses leave the table alone
+    static std::optional<Isbn> find(std::string_view s);
+    std::uint64_t value() const { return val; }
+    bool interned() const { return val & interned_tag; }
+
+    friend bool operator==(Isbn lhs, Isbn rhs) { return lhs.val == rhs.val; }
+    friend bool operator!=(Isbn lhs, Isbn rhs) { return lhs.val != rhs.val; }
+    friend bool operator<(Isbn lhs, Isbn rhs) { return lhs.val < rhs.val; }
+private:
+    static constexpr std::uint64_t packed_tag = std::uint64_t(1) << 62;
+    static constexpr std::uint64_t interned_tag = std::uint64_t(1) << 63;
+    // the 13-digit number of s, or 0 if s is not a valid ISBN-10 or ISBN-13
+    static std::uint64_t pack(std::string_view s);
+    static std::uint64_t intern(std::string_view s);
+    // interned strings; they are kept for the life of the program, one per distinct name
+    // a key was built from, and looked up under a shared lock
+    struct Names {
+        std::shared_mutex m;
+        std::deque<std::string> names; // never moved, so the views below stay valid
+        std::unordered_map<std::string_view, std::uint64_t> ids;
+    };
+    static Names &names() {
+        static Names n;
+        return n;
+    }
+
+    std::uint64_t val = 0;
+};
+
+inline Isbn::Isbn(std::string_view s)
+{
+    if (s.empty())
+        return;
+    auto packed = pack(s);
+    val = packed ? packed_tag | packed : interned_tag | intern(s);
+}
+
+inline std::uint64_t Isbn::pack(std::string_view s)
+{
+    int digits[13], n = 0;
+    for (std::size_t i = 0; i != s.size(); ++i) {
+        char c = s[i];
+        if (c == '-' || c == ' ')
+            continue;
+        if (n == 13)
+            return 0;
+        if (c >= '0' && c <= '9')
+            digits[n++] = c - '0';
+        else if ((c == 'X' || c == 'x') && n == 9 && i + 1 == s.size())
+            digits[n++] = 10; // ISBN-10 check digit 10
+        else
+            return 0;
+    }
+    std::uint64_t v = 0;
+    if (n == 10) {
+        // ISBN-10: validate the check digit, then rewrite as 978 + 9 digits + new check digit
+        int sum = 0;
+        for (int i = 0; i != 10; ++i)
+            sum += (10 - i) * digits[i];
+        if (sum % 11)
+            return 0;
+        int check = 9 * 1 + 7 * 3 + 8 * 1; // weights of the 978 prefix
+        v = 978;
+        for (int i = 0; i != 9; ++i) {
+            check += digits[i] * (i % 2 ? 1 : 3);
+            v = v * 10 + digits[i];
+        }
+        return v * 10 + (10 - check % 10) % 10;
+    }
+    if (n != 13)
+        return 0;
+    int sum = 0;
+    for (int i = 0; i != 13; ++i) {
+        sum += digits[i] * (i % 2 ? 3 : 1);
+        v = v * 10 + digits[i];
+    }
+    return sum % 10 ? 0 : v;
+}
+
+inline std::optional<Isbn> Isbn::find(std::string_view s)
+{
+    Isbn ret;
+    if (s.empty())
+        return ret;
+    if (auto packed = pack(s)) {
+        ret.val = packed_tag | packed;
+        return ret;
+    }
+    auto &t = names();
+    std::shared_lock<std::shared_mutex> lock(t.m);
+    auto it = t.ids.find(s);
+    if (it == t.ids.end())
+        return std::nullopt;
+    ret.val = interned_tag | it->second;
+    return ret;
+}
+
+inline std::uint64_t Isbn::intern(std::string_view s)
+{
+    auto &t = names();
+    {
+        // most names are already known: readers share the lock
+        std::shared_lock<std::shared_mutex> lock(t.m);
+        auto it = t.ids.find(s);
+        if (it != t.ids.end())
+            return it->second;
+    }
+    std::unique_lock<std::shared_mutex> lock(t.m);
+    auto it = t.ids.find(s);
+    if (it != t.ids.end())
+        return it->second;
+    t.names.emplace_back(s);
+    return t.ids.emplace(t.names.back(), t.names.size() - 1).first->second;
+}
+
+// so that Isbn can key the unordered containers
+namespace std {
+template <> struct hash<Isbn> {
+    std::size_t operator()(Isbn i) const noexcept {
+        // packed ISBNs differ mostly in their low digits; mix all bits down anyway
+        auto v = i.value() * 0x9e3779b97f4a7c15ULL;
+        return static_cast<std::size_t>(v ^ (v >> 32));
+    }
+};
+}
+
+#endif
@@ -0,0 +1,129 @@
+#ifndef ISBN_TABLE_H
+#define ISBN_TABLE_H
+
+#include <bits/stdc++.h>
+#include "isbn.h"
+
+// hash table from Isbn to V with open addressing and linear probing
+// keys and values sit in two flat arrays, so a miss reads only keys and copying the table
+// is two array copies; the capacity is a power of two and at most half the slots are used,
+// which keeps probe runs short. Isbn() marks an empty slot and is never a key
+template <typename V> class IsbnTable {
+public:
+    std::size_t size() const { return n; }
+    bool empty() const { return n == 0; }
+    // room for n keys without growing
+    void reserve(std::size_t n);
+    // the value for key, or nullptr
+    const V *find(Isbn key) const;
+    V *find(Isbn key) { return const_cast<V*>(static_cast<const IsbnTable&>(*this).find(key)); }
+    // adds key with value v unless key is already there; returns the value for key and
+    // whether it was added
+    std::pair<V*, bool> insert(Isbn key, V v);
+    // the value for key, added as V() if missing
+    V &operator[](Isbn key) { return *insert(key, V()).first; }
+    // removes key; returns whether it was there
+    bool erase(Isbn key);
+    // calls f(key, value) for every entry, in no particular order
+    template <typename F> void for_each(F f) const {
+        for (std::size_t s = 0; s != keys.size(); ++s)
+            if (keys[s] != Isbn())
+                f(keys[s], vals[s]);
+    }
+private:
+    std::size_t slot(Isbn key) const; // the slot holding key, or the empty one it would go in
+    void rehash(std::size_t capacity);
+
+    std::vector<Isbn> keys;
+    std::vector<V> vals;
+    std::size_t n = 0;
+};
+
+template <typename V>
+inline std::size_t IsbnTable<V>::slot(Isbn key) const
+{
+    auto mask = keys.size() - 1;
+    auto s = std::hash<Isbn>()(key) & mask;
+    while (keys[s] != key && keys[s] != Isbn())
+        s = (s + 1) & mask;
+    return s;
+}
+
+template <typename V>
+inline const V *IsbnTable<V>::find(Isbn key) const
+{
+    if (n == 0 || key == Isbn())
+        return nullptr;
+    auto s = slot(key);
+    return keys[s] == key ? &vals[s] : nullptr;
+}
+
+template <typename V>
+inline void IsbnTable<V>::reserve(std::size_t count)
+{
+    std::size_t cap = 16;
+    while (cap < 2 * count)
+        cap *= 2;
+    if (cap > keys.size())
+        rehash(cap);
+}
+
+template <typename V>
+inline std::pair<V*, bool> IsbnTable<V>::insert(Isbn key, V v)
+{
+    if (key == Isbn())
+        throw std::invalid_argument("IsbnTable: the empty ISBN cannot be a key");
+    if (2 * (n + 1) > keys.size())
+        reserve(n + 1);
+    auto s = slot(key);
+    if (keys[s] == key)
+        return {&vals[s], false};
+    keys[s] = key;
+    vals[s] = std::move(v);
+    ++n;
+    return {&vals[s], true};
+}
+
+template <typename V>
+inline bool IsbnTable<V>::erase(Isbn key)
+{
+    if (n == 0 || key == Isbn())
+        return false;
+    auto mask = keys.size() - 1;
+    auto hole = slot(key);
+    if (keys[hole] == Isbn())
+        return false;
+    --n;
+    // shift later members of the probe run back, so no lookup stops at the hole too early
+    for (auto s = (hole + 1) & mask; keys[s] != Isbn(); s = (s + 1) & mask) {
+        auto home = std::hash<Isbn>()(keys[s]) & mask;
+        if (((s - home) & mask) >= ((s - hole) & mask)) { // home is not in (hole, s]
+            keys[hole] = keys[s];
+            vals[hole] = std::move(vals[s]);
+            hole = s;
+        }
+    }
+    keys[hole] = Isbn();
+    vals[hole] = V();
+    return true;
+}
+
+template <typename V>
+inline void IsbnTable<V>::rehash(std::size_t capacity)
+{
+    std::vector<Isbn> old_keys(capacity);
+    std::vector<V> old_vals(capacity);
+    old_keys.swap(keys);
+    old_vals.swap(vals);
+    auto mask = capacity - 1;
+    for (std::size_t s = 0; s != old_keys.size(); ++s)
+        if (old_keys[s] != Isbn()) {
+            auto t = std::hash<Isbn>()(old_keys[s]) & mask;
+            while (keys[t] != Isbn())
+                t = (t + 1) & mask;
+            keys[t] = old_keys[s];
+            vals[t] = std::move(old_vals[s]);
+        }
+}
+
+#endif
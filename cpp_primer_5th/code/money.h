@@ -0,0 +1,145 @@
+#ifndef MONEY_H
+#define MONEY_H
+
+#include <bits/stdc++.h>
+
+// an amount of money as a whole number of cents in 64 bits
+// sums and products by a count are exact integer arithmetic, so totals never drift and
+// never have to be re-rounded; the only rounding is where a discount is applied, to the
+// nearest cent with halves away from zero
+class Money {
+public:
+    using rep = std::int64_t;
+    static constexpr rep cents_per_unit = 100;
+
+    constexpr Money() = default;
+    // nearest cent to an amount written in units, e.g. Money(19.99)
+    explicit constexpr Money(double units):
+            c(static_cast<rep>(units * cents_per_unit + (units < 0 ? -0.5 : 0.5))) { }
+    static constexpr Money from_cents(rep cents) { Money m; m.c = cents; return m; }
+    static constexpr Money max() { return from_cents(std::numeric_limits<rep>::max()); }
+
+    constexpr rep cents() const { return c; }
+    constexpr double to_double() const { return static_cast<double>(c) / cents_per_unit; }
+
+    constexpr Money &operator+=(Money rhs) { c += rhs.c; return *this; }
+    constexpr Money &operator-=(Money rhs) { c -= rhs.c; return *this; }
+    friend constexpr Money operator+(Money lhs, Money rhs) { return lhs += rhs; }
+    friend constexpr Money operator-(Money lhs, Money rhs) { return lhs -= rhs; }
+    friend constexpr Money operator-(Money m) { return from_cents(-m.c); }
+    // n copies at a price
+    friend constexpr Money operator*(std::size_t n, Money m) { return from_cents(static_cast<rep>(n) * m.c); }
+    friend constexpr Money operator*(Money m, std::size_t n) { return n * m; }
+
+    friend constexpr bool operator==(Money lhs, Money rhs) { return lhs.c == rhs.c; }
+    friend constexpr bool operator!=(Money lhs, Money rhs) { return lhs.c != rhs.c; }
+    friend constexpr bool operator<(Money lhs, Money rhs) { return lhs.c < rhs.c; }
+    friend constexpr bool operator>(Money lhs, Money rhs) { return lhs.c > rhs.c; }
+    friend constexpr bool operator<=(Money lhs, Money rhs) { return lhs.c <= rhs.c; }
+    friend constexpr bool operator>=(Money lhs, Money rhs) { return lhs.c >= rhs.c; }
+private:
+    rep c = 0;
+};
+
+// fraction taken off a price, held exactly in basis points (hundredths of a percent)
+// converts implicitly from a rate such as .15, the way discounts have always been written
+class Discount {
+public:
+    static constexpr std::int64_t one = 10000; // basis points in a rate of 1
+
+    constexpr Discount() = default;
+    constexpr Discount(double rate):
+            bp(static_cast<std::int64_t>(rate * one + (rate < 0 ? -0.5 : 0.5))) { }
+    static constexpr Discount from_basis_points(std::int64_t b) { Discount d; d.bp = b; return d; }
+
+    constexpr std::int64_t basis_points() const { return bp; }
+    constexpr double rate() const { return static_cast<double>(bp) / one; }
+
+    friend constexpr bool operator==(Discount lhs, Discount rhs) { return lhs.bp == rhs.bp; }
+    friend constexpr bool operator!=(Discount lhs, Discount rhs) { return lhs.bp != rhs.bp; }
+private:
+    std::int64_t bp = 0;
+};
+
+// amount less the discount, rounded to the nearest cent with halves away from zero
+// exact as long as amount * 10000 fits in 64 bits, i.e. below about 9 * 10^12 units
+constexpr Money discounted(Money amount, Discount d)
+{
+    auto x = amount.cents() * (Discount::one - d.basis_points());
+    auto half = Discount::one / 2;
+    return Money::from_cents(x >= 0 ? (x + half) / Discount::one : -((-x + half) / Discount::one));
+}
+
+// formats m as [-]units.cents into [first, last), like std::to_chars; 22 chars always suffice
+inline std::to_chars_result to_chars(char *first, char *last, Money m)
+{
+    auto c = m.cents();
+    // the magnitude as unsigned, so the most negative amount works too
+    std::uint64_t mag = c < 0 ? 0 - static_cast<std::uint64_t>(c) : c;
+    if (c < 0) {
+        if (first == last)
+            return {last, std::errc::value_too_large};
+        *first++ = '-';
+    }
+    auto r = std::to_chars(first, last, mag / Money::cents_per_unit);
+    if (r.ec != std::errc())
+        return r;
+    if (last - r.ptr < 3)
+        return {last, std::errc::value_too_large};
+    auto frac = mag % Money::cents_per_unit;
+    r.ptr[0] = '.';
+    r.ptr[1] = static_cast<char>('0' + frac / 10);
+    r.ptr[2] = static_cast<char>('0' + frac % 10);
+    return {r.ptr + 3, std::errc()};
+}
+
+// parses a decimal amount such as 19.99, -3 or .5 from [first, last), like std::from_chars;
+// digits after the cents round the last cent, halves away from zero
+inline std::from_chars_result from_chars(const char *first, const char *last, Money &m)
+{
+    auto p = first;
+    bool neg = p != last && *p == '-';
+    if (neg)
+        ++p;
+    std::uint64_t units = 0;
+    auto digits = p;
+    while (p != last && *p >= '0' && *p <= '9') {
+        if (units > (std::numeric_limits<std::uint64_t>::max() - 9) / 10)
+            return {first, std::errc::result_out_of_range};
+        units = units * 10 + (*p++ - '0');
+    }
+    bool any = p != digits;
+    std::uint64_t cents = 0;
+    if (p != last && *p == '.') {
+        ++p;
+        int n = 0;
+        bool round_up = false;
+        for (; p != last && *p >= '0' && *p <= '9'; ++p, ++n) {
+            if (n < 2)
+                cents = cents * 10 + (*p - '0');
+            else if (n == 2)
+                round_up = *p >= '5';
+            any = true;
+        }
+        for (; n < 2; ++n)
+            cents *= 10;
+        cents += round_up;
+    }
+    if (!any)
+        return {first, std::errc::invalid_argument};
+    auto limit = static_cast<std::uint64_t>(std::numeric_limits<Money::rep>::max());
+    if (units > (limit - cents) / Money::cents_per_unit)
+        return {first, std::errc::result_out_of_range};
+    auto total = static_cast<Money::rep>(units * Money::cents_per_unit + cents);
+    m = Money::from_cents(neg ? -total : total);
+    return {p, std::errc()};
+}
+
+inline std::ostream &operator<<(std::ostream &os, Money m)
+{
+    char buf[24];
+    auto r = to_chars(buf, buf + sizeof(buf), m);
+    return os << std::string_view(buf, r.ptr - buf);
+}
+
+#endif
@@ -0,0 +1,191 @@
+#ifndef POOL_ALLOCATOR_H
+#define POOL_ALLOCATOR_H
+
+#include <bits/stdc++.h>
+
+// free list of fixed-size blocks
+// blocks are carved from chunks and recycled through a cache owned by one thread, so
+// allocating and freeing on that thread take no lock. Every chunk starts with a header
+// naming its cache (chunks are aligned to their size, so the header is found by masking
+// the block address); a block freed on another thread is pushed onto the owning cache's
+// lock-free return stack, which the owner takes back in one exchange before it carves a new
+// chunk. When a thread exits, its chunks are released if all their blocks are free, and
+// otherwise the cache is handed on whole to the next thread that needs one
+template <std::size_t Size, std::size_t Align> class FreeList {
+public:
+    static void *get() {
+        auto c = mine();
+        if (!c)
+            return get_orphaned();
+        return take(*c);
+    }
+    static void put(void *p) noexcept {
+        auto n = static_cast<Node*>(p);
+        auto c = chunk_of(n)->owner;
+        if (c == current()) {
+            n->next = c->head;
+            c->head = n;
+            return;
+        }
+        // another thread's block: give it back to that thread
+        auto top = c->returned.load(std::memory_order_relaxed);
+        do
+            n->next = top;
+        while (!c->returned.compare_exchange_weak(top, n, std::memory_order_release,
+                                                  std::memory_order_relaxed));
+    }
+private:
+    struct Node { Node *next; };
+    struct Cache;
+    struct Chunk {
+        Cache *owner;
+        Chunk *next; // the other chunks of the same cache
+    };
+    struct Cache {
+        Node *head = nullptr; // used by the owning thread only
+        std::atomic<Node*> returned{nullptr}; // blocks freed by other threads
+        Chunk *chunks = nullptr;
+        std::size_t chunk_count = 0;
+        Cache *next_idle = nullptr; // in the list of caches without a thread
+    };
+
+    static constexpr std::size_t pow2_at_least(std::size_t n) {
+        std::size_t p = 1;
+        while (p < n)
+            p *= 2;
+        return p;
+    }
+    static constexpr std::size_t align = Align > alignof(Node) ? Align : alignof(Node);
+    static constexpr std::size_t block = (std::max(Size, sizeof(Node)) + align - 1) / align * align;
+    static constexpr std::size_t header = (sizeof(Chunk) + align - 1) / align * align;
+    // room for at least 64 blocks, rounded up to a power of two so it can be the alignment
+    static constexpr std::size_t chunk_bytes = pow2_at_least(header + 64 * block);
+    static constexpr std::size_t chunk_blocks = (chunk_bytes - header) / block;
+
+    static Chunk *chunk_of(Node *n) {
+        return reinterpret_cast<Chunk*>(reinterpret_cast<std::uintptr_t>(n) & ~(chunk_bytes - 1));
+    }
+    static void *take(Cache &c) {
+        if (!c.head) // first whatever other threads gave back, then a new chunk
+            c.head = c.returned.exchange(nullptr, std::memory_order_acquire);
+        if (!c.head)
+            refill(c);
+        auto n = c.head;
+        c.head = n->next;
+        return n;
+    }
+    static void refill(Cache &c) {
+        auto chunk = static_cast<Chunk*>(::operator new(chunk_bytes, std::align_val_t(chunk_bytes)));
+        chunk->owner = &c;
+        chunk->next = c.chunks;
+        c.chunks = chunk;
+        ++c.chunk_count;
+        auto base = reinterpret_cast<char*>(chunk) + header;
+        for (std::size_t i = chunk_blocks; i != 0; --i) {
+            auto n = reinterpret_cast<Node*>(base + (i - 1) * block);
+            n->next = c.head;
+            c.head = n;
+        }
+    }
+
+    // caches whose thread has exited, waiting for a new owner
+    struct Idle {
+        std::mutex m;
+        Cache *caches = nullptr;
+    };
+    static Idle &idle() {
+        static Idle i;
+        return i;
+    }
+    static Cache *adopt() {
+        auto &i = idle();
+        std::lock_guard<std::mutex> lock(i.m);
+        if (auto c = i.caches) {
+            i.caches = c->next_idle;
+            return c;
+        }
+        return new Cache;
+    }
+    static void retire(Cache *c) {
+        auto r = c->returned.exchange(nullptr, std::memory_order_acquire);
+        while (r) { // all free blocks on one list
+            auto n = r->next;
+            r->next = c->head;
+            c->head = r;
+            r = n;
+        }
+        std::size_t free_blocks = 0;
+        for (auto n = c->head; n; n = n->next)
+            ++free_blocks;
+        if (free_blocks == c->chunk_count * chunk_blocks) {
+            // nothing is in use, so no other thread can return a block: give the memory back
+            while (auto chunk = c->chunks) {
+                c->chunks = chunk->next;
+                ::operator delete(chunk, std::align_val_t(chunk_bytes));
+            }
+            c->head = nullptr;
+            c->chunk_count = 0;
+        }
+        auto &i = idle();
+        std::lock_guard<std::mutex> lock(i.m);
+        c->next_idle = i.caches;
+        i.caches = c;
+    }
+    // owns the calling thread's cache from its first allocation until the thread exits
+    struct Owner {
+        Cache *c;
+        Owner(): c(adopt()) { current() = c; }
+        ~Owner() { current() = nullptr; torn_down() = true; retire(c); }
+    };
+    static Cache *&current() {
+        static thread_local Cache *c = nullptr; // trivially destructible, usable at any time
+        return c;
+    }
+    static Cache *mine() {
+        if (!current() && !torn_down()) {
+            static thread_local Owner owner;
+        }
+        return current();
+    }
+    static bool &torn_down() {
+        static thread_local bool t = false;
+        return t;
+    }
+    // an allocation made while the thread is being torn down borrows an idle cache
+    static void *get_orphaned() {
+        auto c = adopt();
+        auto p = take(*c);
+        auto &i = idle();
+        std::lock_guard<std::mutex> lock(i.m);
+        c->next_idle = i.caches;
+        i.caches = c;
+        return p;
+    }
+};
+
+// allocator that takes single objects from the FreeList for their size
+// meant for allocate_shared: the object and its control block come from one pooled block
+template <typename T> class PoolAllocator {
+public:
+    using value_type = T;
+
+    PoolAllocator() = default;
+    template <typename U> PoolAllocator(const PoolAllocator<U>&) noexcept { }
+
+    T *allocate(std::size_t n) {
+        if (n == 1)
+            return static_cast<T*>(FreeList<sizeof(T), alignof(T)>::get());
+        return std::allocator<T>().allocate(n);
+    }
+    void deallocate(T *p, std::size_t n) noexcept {
+        if (n == 1)
+            FreeList<sizeof(T), alignof(T)>::put(p);
+        else
+            std::allocator<T>().deallocate(p, n);
+    }
+
+    friend bool operator==(const PoolAllocator&, const PoolAllocator&) { return true; }
+    friend bool operator!=(const PoolAllocator&, const PoolAllocator&) { return false; }
+};
+
+#endif
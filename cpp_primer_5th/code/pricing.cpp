@@ -0,0 +1,76 @@
+#include "pricing.h"
+
+using namespace std;
+
+// a discount scheme the batch pricer has no special loop for
+class Clearance_quote : public Quote {
+public:
+    using Quote::Quote;
+    Money net_price(size_t n) const override { return Money::from_cents((n * price).cents() / 2); }
+};
+
+// usage: pricing [quotes]; groups a random catalog once, then prices it both ways for
+// several sets of quantities and compares the results
+int main(int argc, char *argv[]) {
+    size_t n = argc > 1 ? stoul(argv[1]) : 2000000;
+    mt19937 gen(11);
+    vector<unique_ptr<Quote>> catalog;
+    vector<size_t> qty;
+    for (size_t i = 0; i != n; ++i) {
+        string isbn = "book-" + to_string(i);
+        auto price = Money::from_cents(500 + gen() % 9500);
+        switch (gen() % 10) {
+        case 0:
+            catalog.emplace_back(new Clearance_quote(isbn, price));
+            break;
+        case 1: case 2: case 3: case 4:
+            catalog.emplace_back(new Quote(isbn, price));
+            break;
+        default:
+            catalog.emplace_back(new Bulk_quote(isbn, price, 1 + gen() % 20, (gen() % 40) / 100.0));
+        }
+        qty.push_back(1 + gen() % 30);
+    }
+
+    auto ns = [n](chrono::steady_clock::duration d) {
+        return chrono::duration<double, nano>(d).count() / n;
+    };
+    // group the catalog once, as a program would when it loads the catalog
+    auto start = chrono::steady_clock::now();
+    vector<const Quote*> quotes;
+    quotes.reserve(n);
+    for (auto &q : catalog)
+        quotes.push_back(q.get());
+    BatchPricer batch(quotes);
+    auto grouping = chrono::steady_clock::now() - start;
+    cout << "grouping the catalog, once: " << ns(grouping) << " ns/quote" << endl;
+
+    // then price it for several sets of quantities; the result buffers are written once
+    // before timing, so neither side pays their page faults
+    vector<Money> virt(n), prices(n);
+    bool ok = true;
+    chrono::steady_clock::duration virt_total{}, batch_total{};
+    const int rounds = 5;
+    for (int r = 0; r != rounds; ++r) {
+        if (r != 0)
+            for (auto &q : qty)
+                q = 1 + gen() % 30;
+        start = chrono::steady_clock::now();
+        for (size_t i = 0; i != n; ++i)
+            virt[i] = catalog[i]->net_price(qty[i]);
+        auto mid = chrono::steady_clock::now();
+        batch.price(qty, prices);
+        auto stop = chrono::steady_clock::now();
+        virt_total += mid - start;
+        batch_total += stop - mid;
+        ok = ok && prices == virt;
+    }
+    cout << "each pricing: virtual net_price " << ns(virt_total / rounds) << " ns/quote, batch "
+         << ns(batch_total / rounds) << " ns/quote" << endl;
+    cout << rounds << " pricings end to end: virtual " << ns(virt_total) << " ns/quote, batch "
+         << ns(grouping + batch_total) << " ns/quote including the grouping" << endl;
+
+    cout << (ok ? "identical prices" : "prices differ") << ", total "
+         << accumulate(prices.begin(), prices.end(), Money()) << endl;
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,230 @@
+#ifndef PRICING_H
+#define PRICING_H
+
+#include <bits/stdc++.h>
+// the AVX2 kernel and its runtime check exist only on x86; elsewhere the scalar loop is used
+#if defined(__x86_64__) || defined(__i386__)
+#define PRICING_HAVE_AVX2 1
+#include <immintrin.h>
+#else
+#define PRICING_HAVE_AVX2 0
+#endif
+#include "quote.h"
+
+// Bulk_quote::net_price over structure-of-arrays input, all in integers:
+//   out[i] = qty[i] >= min_qty[i] ? discounted(qty[i] * price[i], discount[i]) : qty[i] * price[i]
+// with prices and results in cents and discounts in basis points (see money.h)
+inline void bulk_net_price_scalar(const std::int64_t *price, const std::int64_t *min_qty,
+                                  const std::int64_t *discount, const std::int64_t *qty,
+                                  std::int64_t *out, std::size_t n)
+{
+    for (std::size_t i = 0; i != n; ++i) {
+        auto full = Money::from_cents(qty[i] * price[i]);
+        auto disc = discounted(full, Discount::from_basis_points(discount[i]));
+        out[i] = (qty[i] >= min_qty[i] ? disc : full).cents();
+    }
+}
+
+#if PRICING_HAVE_AVX2
+// conversions between int64 and double lanes, which AVX2 lacks: a non-negative integer
+// below 2^52 plus 2^52 has the integer as its mantissa bits
+__attribute__((target("avx2")))
+inline __m256d epi64_to_pd(__m256i v)
+{
+    const __m256d magic = _mm256_set1_pd(4503599627370496.0); // 2^52
+    return _mm256_sub_pd(_mm256_castsi256_pd(_mm256_or_si256(v, _mm256_castpd_si256(magic))), magic);
+}
+
+__attribute__((target("avx2")))
+inline __m256i pd_to_epi64(__m256d v)
+{
+    const __m256d magic = _mm256_set1_pd(4503599627370496.0);
+    return _mm256_sub_epi64(_mm256_castpd_si256(_mm256_add_pd(v, magic)), _mm256_castpd_si256(magic));
+}
+
+__attribute__((target("avx2")))
+inline __m256i load_epi64(const std::int64_t *p)
+{
+    return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+}
+
+// the same computation four quotes at a time; the branch becomes a blend
+// AVX2 has no 64-bit integer multiply or divide, so the products are formed in doubles:
+// integers below 2^52 are exact there, and for such a product x the correctly rounded
+// x / 10000 never lands on the wrong side of a half cent, so flooring it plus one half
+// gives the same cent as the integer code. Every input must be non-negative and
+// qty * price * 10000 must stay below 2^52; BatchPricer checks this before using the kernel
+__attribute__((target("avx2")))
+inline void bulk_net_price_avx2(const std::int64_t *price, const std::int64_t *min_qty,
+                                const std::int64_t *discount, const std::int64_t *qty,
+                                std::int64_t *out, std::size_t n)
+{
+    const __m256d one = _mm256_set1_pd(Discount::one), half = _mm256_set1_pd(0.5);
+    std::size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        __m256i q = load_epi64(qty + i);
+        __m256d full = _mm256_mul_pd(epi64_to_pd(q), epi64_to_pd(load_epi64(price + i)));
+        __m256d keep = _mm256_sub_pd(one, epi64_to_pd(load_epi64(discount + i)));
+        __m256d disc = _mm256_floor_pd(_mm256_add_pd(_mm256_div_pd(_mm256_mul_pd(full, keep), one), half));
+        __m256i below = _mm256_cmpgt_epi64(load_epi64(min_qty + i), q); // no discount
+        __m256i res = _mm256_blendv_epi8(pd_to_epi64(disc), pd_to_epi64(full), below);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i), res);
+    }
+    bulk_net_price_scalar(price + i, min_qty + i, discount + i, qty + i, out + i, n - i);
+}
+
+#endif
+
+// picks the AVX2 kernel when the CPU running the program has it
+inline void bulk_net_price(const std::int64_t *price, const std::int64_t *min_qty,
+                           const std::int64_t *discount, const std::int64_t *qty,
+                           std::int64_t *out, std::size_t n)
+{
+#if PRICING_HAVE_AVX2
+    static const bool avx2 = __builtin_cpu_supports("avx2");
+    if (avx2) {
+        bulk_net_price_avx2(price, min_qty, discount, qty, out, n);
+        return;
+    }
+#endif
+    bulk_net_price_scalar(price, min_qty, discount, qty, out, n);
+}
+
+// a set of quotes grouped for pricing without virtual calls
+// the quotes are sorted once, by dynamic type, into structure-of-arrays groups: build a
+// BatchPricer when a catalog is loaded and keep it next to the catalog. Each price() call
+// then prices every group by a loop over contiguous arrays (bulk_net_price for
+// Bulk_quote), and quotes of other derived types fall back to the virtual net_price
+// grouping costs more than one pricing pass, so a BatchPricer built for a single pricing
+// is slower than calling net_price directly; it pays off from the second pricing on
+// the arithmetic is the same as in Quote::net_price and Bulk_quote::net_price, so the
+// results are identical; the quotes must outlive the BatchPricer
+class BatchPricer {
+public:
+    BatchPricer() = default;
+    explicit BatchPricer(const std::vector<const Quote*> &quotes);
+    // room for n quotes, so that add() never reallocates
+    void reserve(std::size_t n);
+    // add a quote; returns its index in the quantities and results of price()
+    std::size_t add(const Quote &q);
+    std::size_t size() const { return count; }
+    // net price of qty[i] copies of quote i, for every quote
+    std::vector<Money> price(const std::vector<std::size_t> &qty) const {
+        std::vector<Money> ret;
+        price(qty, ret);
+        return ret;
+    }
+    // the same into out, so that a caller pricing again can reuse its buffer
+    void price(const std::vector<std::size_t> &qty, std::vector<Money> &out) const;
+private:
+    struct PlainGroup { // Quote: qty * price, in cents
+        std::vector<std::int64_t> price;
+        std::vector<std::size_t> slot; // where each result goes
+    };
+    struct BulkGroup { // Bulk_quote: discounted once qty reaches min_qty
+        // everything is kept as int64 so that the loop works on one element type
+        std::vector<std::int64_t> price, min_qty, discount;
+        std::vector<std::size_t> max_qty; // largest qty the kernel prices exactly
+        std::vector<const Quote*> quote; // for larger ones
+        std::vector<std::size_t> slot;
+    };
+    struct OtherGroup { // any other derived class
+        std::vector<const Quote*> quote;
+        std::vector<std::size_t> slot;
+    };
+
+    PlainGroup plain;
+    BulkGroup bulk;
+    OtherGroup other;
+    std::size_t count = 0;
+};
+
+inline BatchPricer::BatchPricer(const std::vector<const Quote*> &quotes)
+{
+    reserve(quotes.size());
+    for (auto q : quotes)
+        add(*q);
+}
+
+inline void BatchPricer::reserve(std::size_t n)
+{
+    // reserving only takes address space; the pages of the groups that stay small are
+    // never touched
+    plain.price.reserve(n);
+    plain.slot.reserve(n);
+    for (auto v : {&bulk.price, &bulk.min_qty, &bulk.discount})
+        v->reserve(n);
+    bulk.max_qty.reserve(n);
+    bulk.quote.reserve(n);
+    bulk.slot.reserve(n);
+    other.quote.reserve(n);
+    other.slot.reserve(n);
+}
+
+inline std::size_t BatchPricer::add(const Quote &q)
+{
+    auto slot = count++;
+    auto &type = typeid(q);
+    if (type == typeid(Quote)) {
+        plain.price.push_back(q.base_price().cents());
+        plain.slot.push_back(slot);
+        return slot;
+    }
+    auto bq = type == typeid(Bulk_quote) ? static_cast<const Bulk_quote*>(&q) : nullptr;
+    auto disc = bq ? bq->discount_rate().basis_points() : -1;
+    auto price = q.base_price().cents();
+    if (bq && price >= 0 && disc >= 0 && disc <= Discount::one) {
+        // the AVX2 kernel is exact below 2^52 (see above); larger lines take the virtual call
+        const std::uint64_t qty_limit = std::uint64_t(1) << 32;
+        bulk.price.push_back(price);
+        bulk.max_qty.push_back(price == 0 ? qty_limit - 1
+            : std::min(qty_limit - 1, ((std::uint64_t(1) << 52) / Discount::one - 1) / price));
+        // any threshold above every qty the kernel sees gives the same answer
+        bulk.min_qty.push_back(std::min<std::uint64_t>(bq->min_quantity(), qty_limit));
+        bulk.discount.push_back(disc);
+        bulk.quote.push_back(&q);
+        bulk.slot.push_back(slot);
+    } else {
+        other.quote.push_back(&q);
+        other.slot.push_back(slot);
+    }
+    return slot;
+}
+
+inline void BatchPricer::price(const std::vector<std::size_t> &qty, std::vector<Money> &ret) const
+{
+    if (qty.size() != size())
+        throw std::invalid_argument("BatchPricer::price: one quantity per quote");
+    ret.resize(qty.size());
+    for (std::size_t i = 0; i != plain.price.size(); ++i) {
+        auto s = plain.slot[i];
+        ret[s] = Money::from_cents(std::int64_t(qty[s]) * plain.price[i]);
+    }
+
+    // gather the quantities into a contiguous buffer, price it, then scatter the results;
+    // quantities too large for the kernel get 0 there and the virtual call afterwards
+    // the buffers are per thread and reused, so repeated pricings do not fault in new pages
+    static thread_local std::vector<std::int64_t> q, tmp;
+    static thread_local std::vector<std::size_t> large;
+    q.resize(bulk.price.size());
+    tmp.resize(bulk.price.size());
+    large.clear();
+    for (std::size_t i = 0; i != q.size(); ++i) {
+        q[i] = qty[bulk.slot[i]];
+        if (qty[bulk.slot[i]] > bulk.max_qty[i]) {
+            q[i] = 0;
+            large.push_back(i);
+        }
+    }
+    bulk_net_price(bulk.price.data(), bulk.min_qty.data(), bulk.discount.data(),
+                   q.data(), tmp.data(), tmp.size());
+    for (std::size_t i = 0; i != tmp.size(); ++i)
+        ret[bulk.slot[i]] = Money::from_cents(tmp[i]);
+    for (auto i : large)
+        ret[bulk.slot[i]] = bulk.quote[i]->net_price(qty[bulk.slot[i]]);
+
+    for (std::size_t i = 0; i != other.quote.size(); ++i)
+        ret[other.slot[i]] = other.quote[i]->net_price(qty[other.slot[i]]);
+}
+
+#endif
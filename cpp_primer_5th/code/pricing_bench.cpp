@@ -0,0 +1,57 @@
+#include "pricing.h"
+
+using namespace std;
+
+// usage: pricing_bench; throughput of the Bulk_quote pricing kernels in quotes per second,
+// for arrays that fit in cache and for arrays that have to stream from memory
+
+using Kernel = void (*)(const int64_t*, const int64_t*, const int64_t*, const int64_t*,
+                        int64_t*, size_t);
+
+double quotes_per_second(Kernel k, const vector<int64_t> &price, const vector<int64_t> &min_qty,
+                         const vector<int64_t> &discount, const vector<int64_t> &qty,
+                         vector<int64_t> &out)
+{
+    size_t n = price.size(), done = 0;
+    auto start = chrono::steady_clock::now();
+    chrono::duration<double> elapsed{0};
+    // repeat until the measurement is long enough to be stable
+    while (elapsed.count() < 0.2) {
+        k(price.data(), min_qty.data(), discount.data(), qty.data(), out.data(), n);
+        done += n;
+        elapsed = chrono::steady_clock::now() - start;
+    }
+    return done / elapsed.count();
+}
+
+int main() {
+#if PRICING_HAVE_AVX2
+    bool avx2 = __builtin_cpu_supports("avx2");
+#else
+    bool avx2 = false;
+#endif
+    cout << "AVX2 " << (avx2 ? "available" : "not available") << endl;
+    for (size_t n : {size_t(4096), size_t(1) << 16, size_t(1) << 24}) {
+        mt19937 gen(3);
+        // cents and basis points, as BatchPricer passes them
+        vector<int64_t> price(n), min_qty(n), discount(n), qty(n), a(n), b(n);
+        for (size_t i = 0; i != n; ++i) {
+            price[i] = 500 + gen() % 9500;
+            min_qty[i] = 1 + gen() % 20;
+            discount[i] = gen() % 40 * 100;
+            qty[i] = 1 + gen() % 30;
+        }
+        cout << setw(9) << n << " quotes: scalar "
+             << quotes_per_second(bulk_net_price_scalar, price, min_qty, discount, qty, a) / 1e6
+             << " M/s";
+#if PRICING_HAVE_AVX2
+        if (avx2) {
+            cout << ", avx2 "
+                 << quotes_per_second(bulk_net_price_avx2, price, min_qty, discount, qty, b) / 1e6
+                 << " M/s" << (a == b ? "" : " (results differ!)");
+        }
+#endif
+        cout << endl;
+    }
+    return 0;
+}
@@ -0,0 +1,123 @@
+#include "promotions.h"
+#include "bench.h"
+
+using namespace std;
+
+// usage: promotions [baskets]; shows a few rules on one basket, then times evaluating
+// random baskets as the number of rules grows, against checking every rule in turn
+
+// the straightforward way: every line tries every rule, in order
+Money evaluate_each_rule(const vector<PromotionRule> &rules, const Basket &b, time_t now)
+{
+    unordered_map<Isbn, size_t> qty;
+    b.for_each_line([&](const Quote &q, size_t n, Money) { qty[q.isbn_key()] = n; });
+    Money total;
+    b.for_each_line([&](const Quote &q, size_t n, Money net) {
+        Money amount = net;
+        for (auto &rule : rules) {
+            if (auto t = get_if<TieredBreak>(&rule)) {
+                if (!t->when.contains(now) || Isbn(t->book) != q.isbn_key())
+                    continue;
+                size_t best = 0;
+                Discount d;
+                for (auto &tier : t->tiers)
+                    if (tier.first <= n && tier.first >= best) {
+                        best = tier.first;
+                        d = tier.second;
+                    }
+                amount = discounted(amount, d);
+            } else if (auto bu = get_if<Bundle>(&rule)) {
+                if (!bu->when.contains(now) || Isbn(bu->get) != q.isbn_key())
+                    continue;
+                size_t eligible = bu->buy == bu->get || Isbn(bu->buy) == Isbn(bu->get)
+                    ? n / (bu->buy_qty + bu->get_qty) * bu->get_qty
+                    : min(n, qty[Isbn(bu->buy)] / bu->buy_qty * bu->get_qty);
+                auto full = eligible * q.base_price();
+                amount = max(Money(), amount - (full - discounted(full, bu->discount)));
+            } else {
+                auto &c = get<LineCap>(rule);
+                if (c.when.contains(now) && Isbn(c.book) == q.isbn_key())
+                    amount = min(amount, c.cap);
+            }
+        }
+        total += amount;
+    });
+    return total;
+}
+
+int main(int argc, char *argv[]) {
+    size_t nbaskets = argc > 1 ? stoul(argv[1]) : 20000;
+    time_t now = 1700000000;
+
+    Basket b;
+    b.add_item(Quote("0-201-82470-1", Money(50)), 12);
+    b.add_item(Bulk_quote("0-201-54848-8", Money(40), 10, .1), 3);
+    b.add_item(Quote("0-201-70353-X", Money(30)), 2);
+    vector<PromotionRule> rules = {
+        TieredBreak{"0-201-82470-1", {{5, .05}, {10, .1}}, {}}, // 12 copies: 10% off
+        Bundle{"0-201-82470-1", 4, "0-201-54848-8", 1, 1.0, {}}, // every 4 of one, 1 free of the other
+        LineCap{"0-201-82470-1", Money(500), {}},
+        Bundle{"0-201-70353-X", 1, "0-201-70353-X", 1, .5, {now + 3600, now + 7200}}, // not yet
+    };
+    PromotionTable table(rules);
+    cout << "basket " << b.total() << ", with promotions " << table.evaluate(b, now)
+         << ", an hour later " << table.evaluate(b, now + 3600) << endl;
+
+    // books with valid ISBN-13s; baskets favour the first few hundred of them
+    const size_t nbooks = 100000;
+    vector<shared_ptr<Quote>> books;
+    for (size_t i = 0; i != nbooks; ++i) {
+        string isbn = make_isbn(i * 7919);
+        if (i % 3)
+            books.push_back(make_shared<Quote>(isbn, Money::from_cents(500 + i % 9500)));
+        else
+            books.push_back(make_shared<Bulk_quote>(isbn, Money::from_cents(500 + i % 9500), 5, .1));
+    }
+    mt19937 gen(21);
+    auto pick = [&] { return gen() % 2 ? gen() % 500 : gen() % nbooks; };
+    vector<Basket> baskets(nbaskets);
+    for (auto &bk : baskets)
+        for (size_t lines = 1 + gen() % 10; lines; --lines)
+            bk.add_item(books[pick()], 1 + gen() % 12);
+
+    cout << setw(8) << "rules" << setw(14) << "compiled ns" << setw(16) << "each rule ns" << endl;
+    bool ok = true;
+    for (size_t nrules : {10, 100, 1000, 10000, 100000}) {
+        vector<PromotionRule> rs;
+        for (size_t i = 0; i != nrules; ++i) {
+            Window w;
+            if (gen() % 5 == 0) // a fifth of the rules run for a limited time, half of them now
+                w = gen() % 2 ? Window{now - 60, now + 60} : Window{now + 60, now + 120};
+            auto &book = books[pick()]->isbn();
+            switch (gen() % 3) {
+            case 0:
+                rs.push_back(TieredBreak{book, {{3, .05}, {6, .1}, {10, .15}}, w});
+                break;
+            case 1:
+                rs.push_back(Bundle{books[pick()]->isbn(), 1 + gen() % 3, book, 1, gen() % 2 ? 1.0 : .5, w});
+                break;
+            default:
+                rs.push_back(LineCap{book, Money::from_cents(2000 + gen() % 20000), w});
+            }
+        }
+        PromotionTable t(rs);
+        vector<Money> fast(nbaskets);
+        t.evaluate(baskets[0], now); // size the registers outside the timing
+        double compiled = ns_per(nbaskets, [&] {
+            for (size_t i = 0; i != nbaskets; ++i)
+                fast[i] = t.evaluate(baskets[i], now);
+        });
+        // checking every rule is far slower; a sample of the baskets is enough
+        size_t sample = min(nbaskets, max<size_t>(20, 2000000 / nrules));
+        vector<Money> slow(sample);
+        double each = ns_per(sample, [&] {
+            for (size_t i = 0; i != sample; ++i)
+                slow[i] = evaluate_each_rule(rs, baskets[i], now);
+        });
+        bool same = equal(slow.begin(), slow.end(), fast.begin());
+        ok = ok && same;
+        cout << setw(8) << nrules << setw(14) << compiled << setw(16) << each
+             << (same ? "" : "  (results differ!)") << endl;
+    }
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,197 @@
+#ifndef PROMOTIONS_H
+#define PROMOTIONS_H
+
+#include <bits/stdc++.h>
+#include "basket.h"
+#include "isbn_table.h"
+
+// promotion rules on top of the quotes' own pricing
+// rules are written as plain values and compiled into a PromotionTable: every book a rule
+// mentions gets a register, and the rules that change a book's line become a short run of
+// instructions stored next to each other. Evaluating a Basket walks its lines once to load
+// the registers, then runs only the instructions of the books that are in the basket, so
+// the cost follows the basket and the rules on its books, not the number of rules
+
+// when a rule applies: from <= now < to
+struct Window {
+    std::time_t from = std::numeric_limits<std::time_t>::min();
+    std::time_t to = std::numeric_limits<std::time_t>::max();
+    bool contains(std::time_t t) const { return from <= t && t < to; }
+};
+
+struct TieredBreak { // the discount of the highest tier reached, on the whole line
+    std::string book;
+    std::vector<std::pair<std::size_t, Discount>> tiers; // (min_qty, discount)
+    Window when;
+};
+
+struct Bundle { // for every buy_qty copies of buy, get_qty copies of get at a discount
+    std::string buy;
+    std::size_t buy_qty = 1;
+    std::string get;
+    std::size_t get_qty = 1;
+    Discount discount = 1.0; // 1: free
+    Window when;
+};
+
+struct LineCap { // never charge more than cap for the line of book
+    std::string book;
+    Money cap;
+    Window when;
+};
+
+using PromotionRule = std::variant<TieredBreak, Bundle, LineCap>;
+
+class PromotionTable {
+public:
+    PromotionTable() = default;
+    // rules that change the same book are applied to its line in the order given
+    explicit PromotionTable(const std::vector<PromotionRule> &rules);
+
+    // the basket's total after every promotion active at now
+    Money evaluate(const Basket &b, std::time_t now) const;
+    std::size_t books() const { return regs_of.size(); }
+    std::size_t instructions() const { return code.size(); }
+private:
+    enum class Op : std::uint8_t {
+        tier, // a: first tier in tiers, b: number of tiers
+        bundle, // arg: register of the book to buy, a: buy_qty, b: get_qty, value: discount
+        bundle_same, // buy and get are the same book
+        cap // value: cap in cents
+    };
+    struct Instr {
+        Op op;
+        std::uint32_t arg;
+        std::size_t a, b;
+        std::int64_t value;
+        Window when;
+    };
+    // what evaluate() knows about a book of the basket
+    struct Reg {
+        std::size_t qty = 0; // 0: the book is not in the basket
+        Money net; // the line as the basket prices it
+        Money base; // price of one copy
+    };
+    static constexpr std::uint32_t npos = std::numeric_limits<std::uint32_t>::max();
+
+    std::uint32_t reg(Isbn key) const; // register of key, or npos
+    std::uint32_t add_reg(Isbn key); // register of key, made if needed
+    Money run(std::uint32_t r, std::time_t now, const Reg *regs) const;
+
+    IsbnTable<std::uint32_t> regs_of; // register of each book, numbered from 0
+    std::vector<std::uint32_t> first_instr; // register r runs code[first_instr[r], first_instr[r + 1])
+    std::vector<Instr> code;
+    std::vector<std::pair<std::size_t, Discount>> tiers; // ascending min_qty within each rule
+};
+
+inline std::uint32_t PromotionTable::reg(Isbn key) const
+{
+    auto r = regs_of.find(key);
+    return r ? *r : npos;
+}
+
+inline std::uint32_t PromotionTable::add_reg(Isbn key)
+{
+    if (key == Isbn())
+        throw std::invalid_argument("promotion rule without a book");
+    return *regs_of.insert(key, static_cast<std::uint32_t>(regs_of.size())).first;
+}
+
+inline PromotionTable::PromotionTable(const std::vector<PromotionRule> &rules)
+{
+    // compile each rule to one instruction for the register of the line it changes
+    std::vector<std::pair<std::uint32_t, Instr>> out;
+    for (auto &rule : rules) {
+        if (auto t = std::get_if<TieredBreak>(&rule)) {
+            auto r = add_reg(Isbn(t->book));
+            auto sorted = t->tiers;
+            std::stable_sort(sorted.begin(), sorted.end(),
+                             [](const std::pair<std::size_t, Discount> &x,
+                                const std::pair<std::size_t, Discount> &y) { return x.first < y.first; });
+            out.push_back({r, {Op::tier, 0, tiers.size(), sorted.size(), 0, t->when}});
+            tiers.insert(tiers.end(), sorted.begin(), sorted.end());
+        } else if (auto b = std::get_if<Bundle>(&rule)) {
+            if (b->buy_qty == 0)
+                throw std::invalid_argument("bundle with buy_qty 0");
+            auto get = add_reg(Isbn(b->get)), buy = add_reg(Isbn(b->buy));
+            out.push_back({get, {buy == get ? Op::bundle_same : Op::bundle, buy, b->buy_qty,
+                                 b->get_qty, b->discount.basis_points(), b->when}});
+        } else {
+            auto &c = std::get<LineCap>(rule);
+            out.push_back({add_reg(Isbn(c.book)), {Op::cap, 0, 0, 0, c.cap.cents(), c.when}});
+        }
+    }
+    // group the instructions by register, keeping the rule order within each
+    std::stable_sort(out.begin(), out.end(),
+                     [](const std::pair<std::uint32_t, Instr> &x,
+                        const std::pair<std::uint32_t, Instr> &y) { return x.first < y.first; });
+    first_instr.assign(books() + 1, 0);
+    for (auto &i : out) {
+        ++first_instr[i.first + 1];
+        code.push_back(i.second);
+    }
+    for (std::size_t r = 1; r < first_instr.size(); ++r)
+        first_instr[r] += first_instr[r - 1];
+}
+
+inline Money PromotionTable::run(std::uint32_t r, std::time_t now, const Reg *regs) const
+{
+    auto &line = regs[r];
+    Money amount = line.net;
+    for (auto i = first_instr[r]; i != first_instr[r + 1]; ++i) {
+        auto &in = code[i];
+        if (!in.when.contains(now))
+            continue;
+        switch (in.op) {
+        case Op::tier: {
+            Discount d;
+            for (auto t = in.a; t != in.a + in.b && tiers[t].first <= line.qty; ++t)
+                d = tiers[t].second;
+            amount = discounted(amount, d);
+            break;
+        }
+        case Op::bundle:
+        case Op::bundle_same: {
+            // copies that qualify, taken off at the undiscounted price
+            std::size_t eligible = in.op == Op::bundle_same
+                ? line.qty / (in.a + in.b) * in.b
+                : std::min(line.qty, regs[in.arg].qty / in.a * in.b);
+            auto full = eligible * line.base;
+            auto saving = full - discounted(full, Discount::from_basis_points(in.value));
+            amount = std::max(Money(), amount - saving);
+            break;
+        }
+        case Op::cap:
+            amount = std::min(amount, Money::from_cents(in.value));
+            break;
+        }
+    }
+    return amount;
+}
+
+inline Money PromotionTable::evaluate(const Basket &b, std::time_t now) const
+{
+    // registers are per thread and all zero between calls; only the used ones are reset
+    static thread_local std::vector<Reg> regs;
+    static thread_local std::vector<std::uint32_t> used;
+    if (regs.size() < books())
+        regs.resize(books());
+    used.clear();
+    Money total;
+    b.for_each_line([&](const Quote &q, std::size_t qty, Money net) {
+        auto r = reg(q.isbn_key());
+        if (r == npos) {
+            total += net; // no promotion mentions this book
+            return;
+        }
+        regs[r] = {qty, net, q.base_price()};
+        used.push_back(r);
+    });
+    for (auto r : used)
+        total += run(r, now, regs.data());
+    for (auto r : used)
+        regs[r] = Reg();
+    return total;
+}
+
+#endif
@@ -0,0 +1,89 @@
+#ifndef QUOTE_H
+#define QUOTE_H
+
+#include <bits/stdc++.h>
+#include "isbn.h"
+#include "money.h"
+#include "pool_allocator.h"
+
+class Quote {
+public:
+    Quote() = default; // = default see § 7.1.4
+    Quote(const std::string &book, Money sales_price):
+            bookNo(book), key(book), price(sales_price) { }
+    const std::string &isbn() const { return bookNo; }
+    // packed form of the ISBN, cheap to compare; see isbn.h
+    Isbn isbn_key() const { return key; }
+    Money base_price() const { return price; } // price of one copy before any discount
+    // returns the total sales price for the specified number of items
+    // derived classes will override and apply different discount algorithms
+    virtual Money net_price(std::size_t n) const
+    {
+        return n * price;
+    }
+    virtual ~Quote() = default; // dynamic binding for the destructor
+
+    // virtual function to return a dynamically allocated copy of itself
+    // these members use reference qualifiers; see §13.6.3
+    virtual Quote* clone() const &
+    {
+        return new Quote(*this);
+    }
+    virtual Quote* clone() &&
+    {
+        return new Quote(std::move(*this));
+    }
+    // same, but the copy and its reference count share one block from a recycled pool
+    virtual std::shared_ptr<Quote> clone_shared() const &
+    {
+        return std::allocate_shared<Quote>(PoolAllocator<Quote>(), *this);
+    }
+    virtual std::shared_ptr<Quote> clone_shared() &&
+    {
+        return std::allocate_shared<Quote>(PoolAllocator<Quote>(), std::move(*this));
+    }
+private:
+    std::string bookNo; // ISBN number of this item
+    Isbn key; // bookNo packed into an integer
+protected:
+    Money price; // normal, undiscounted price
+};
+
+class Bulk_quote : public Quote { // Bulk_quote inherits from Quote
+public:
+    Bulk_quote() = default;
+    Bulk_quote(const std::string& book, Money p, std::size_t qty, Discount disc) :
+            Quote(book, p), min_qty(qty), discount(disc) { }
+    // overrides the base version in order to implement the bulk purchase discount policy
+    // if the specified number of items are purchased, use the discounted price
+    Money net_price(size_t cnt) const override
+    {
+        if (cnt >= min_qty)
+            return discounted(cnt * price, discount);
+        else
+            return cnt * price;
+    }
+    std::size_t min_quantity() const { return min_qty; }
+    Discount discount_rate() const { return discount; }
+    Bulk_quote* clone() const &
+    {
+        return new Bulk_quote(*this);
+    }
+    Bulk_quote* clone() &&
+    {
+        return new Bulk_quote(std::move(*this));
+    }
+    std::shared_ptr<Quote> clone_shared() const & override
+    {
+        return std::allocate_shared<Bulk_quote>(PoolAllocator<Bulk_quote>(), *this);
+    }
+    std::shared_ptr<Quote> clone_shared() && override
+    {
+        return std::allocate_shared<Bulk_quote>(PoolAllocator<Bulk_quote>(), std::move(*this));
+    }
+private:
+    std::size_t min_qty = 0; // minimum purchase for the discount to apply
+    Discount discount; // fractional discount to apply
+};
+
+#endif
@@ -0,0 +1,54 @@
+#include "quote_policy.h"
+#include "basket.h"
+
+using namespace std;
+
+// usage: quote_policy [quotes]; prices the same random catalog through the virtual
+// hierarchy and through PolicyQuote, and shows a composed policy inside a Basket
+int main(int argc, char *argv[]) {
+    size_t n = argc > 1 ? stoul(argv[1]) : 2000000;
+
+    // stacked schemes become one type; a Policy_quote goes into a Basket like any Quote
+    using Member_tiered = Pricing<TieredPrice, MemberDiscount, PriceCap>;
+    Basket b;
+    b.add_item(Policy_quote<Member_tiered>("0-201-82470-1", Money(50),
+               {{{5, 10, 20}, {.05, .1, .2}}, {MemberDiscount{.05}, PriceCap{Money(1000)}}}), 12);
+    b.add_item(Policy_quote<Pricing<LimitedPrice>>("0-201-54848-8", Money(40), {{3, .5}, {}}), 4);
+    b.total_receipt(cout);
+
+    mt19937 gen(11);
+    vector<unique_ptr<Quote>> hierarchy;
+    vector<PolicyQuote> policies;
+    vector<size_t> qty;
+    for (size_t i = 0; i != n; ++i) {
+        string isbn = "book-" + to_string(i);
+        auto price = Money::from_cents(500 + gen() % 9500);
+        if (gen() % 2)
+            hierarchy.emplace_back(new Quote(isbn, price));
+        else
+            hierarchy.emplace_back(new Bulk_quote(isbn, price, 1 + gen() % 20, gen() % 40 / 100.0));
+        policies.emplace_back(*hierarchy.back());
+        qty.push_back(1 + gen() % 30);
+    }
+
+    auto time = [n](auto f) {
+        auto start = chrono::steady_clock::now();
+        auto sum = f();
+        return make_pair(sum, chrono::duration<double, nano>(chrono::steady_clock::now() - start).count() / n);
+    };
+    auto virt = time([&] {
+        Money sum;
+        for (size_t i = 0; i != n; ++i)
+            sum += hierarchy[i]->net_price(qty[i]);
+        return sum;
+    });
+    auto visit = time([&] {
+        Money sum;
+        for (size_t i = 0; i != n; ++i)
+            sum += policies[i].net_price(qty[i]);
+        return sum;
+    });
+    cout << "virtual net_price: " << virt.second << " ns/quote, total " << virt.first << endl;
+    cout << "PolicyQuote (std::visit): " << visit.second << " ns/quote, total " << visit.first << endl;
+    return virt.first == visit.first ? 0 : 1;
+}
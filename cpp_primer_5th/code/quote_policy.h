@@ -0,0 +1,137 @@
+#ifndef QUOTE_POLICY_H
+#define QUOTE_POLICY_H
+
+#include <bits/stdc++.h>
+#include "quote.h"
+
+// discount schemes as small value types that are composed at compile time
+// a Pricing<Base, Adjusters...> first prices n copies with its base policy, then passes
+// the amount through each adjuster in turn; every call is known statically, so the whole
+// chain inlines into one expression
+// quotes that use different schemes share the PolicyQuote type, which holds the scheme in
+// a std::variant and dispatches with std::visit instead of a virtual call
+
+// base policies: price n copies at a unit price
+struct FlatPrice { // as Quote::net_price
+    Money net(std::size_t n, Money price) const { return n * price; }
+};
+
+struct BulkPrice { // as Bulk_quote::net_price
+    std::size_t min_qty = 0; // minimum purchase for the discount to apply
+    Discount discount; // fractional discount to apply
+    Money net(std::size_t n, Money price) const {
+        return n >= min_qty ? discounted(n * price, discount) : n * price;
+    }
+};
+
+struct LimitedPrice { // discount for at most max_qty copies, full price for the rest
+    std::size_t max_qty = 0;
+    Discount discount;
+    Money net(std::size_t n, Money price) const {
+        auto cheap = std::min(n, max_qty);
+        return discounted(cheap * price, discount) + (n - cheap) * price;
+    }
+};
+
+struct TieredPrice { // the discount of the highest tier whose min_qty is reached
+    // ascending; up to three tiers, the ones left out stay {0, 0} and are skipped
+    std::array<std::size_t, 3> min_qty{};
+    std::array<Discount, 3> discount{};
+    Money net(std::size_t n, Money price) const {
+        Discount d;
+        for (std::size_t i = 0; i != min_qty.size(); ++i)
+            if (min_qty[i] != 0 || discount[i] != Discount())
+                d = n >= min_qty[i] ? discount[i] : d;
+        return discounted(n * price, d);
+    }
+};
+
+// adjusters: change an amount already computed by the base policy
+struct MemberDiscount { // loyalty discount on top of everything else
+    Discount discount;
+    Money adjust(std::size_t, Money amount) const { return discounted(amount, discount); }
+};
+
+struct PriceCap { // never charge more than cap for the whole line
+    Money cap = Money::max();
+    Money adjust(std::size_t, Money amount) const { return std::min(amount, cap); }
+};
+
+template <typename Base, typename... Adjusters> struct Pricing {
+    Base base;
+    std::tuple<Adjusters...> adjusters;
+
+    Money net(std::size_t n, Money price) const {
+        Money amount = base.net(n, price);
+        // fold over the adjusters in the order they are listed
+        std::apply([&](const Adjusters&... a) { ((amount = a.adjust(n, amount)), ...); },
+                   adjusters);
+        return amount;
+    }
+};
+
+// the schemes a PolicyQuote can use; adding a scheme means adding a line here
+using PricePolicy = std::variant<
+    Pricing<FlatPrice>,
+    Pricing<BulkPrice>,
+    Pricing<LimitedPrice>,
+    Pricing<TieredPrice>,
+    Pricing<BulkPrice, MemberDiscount>,
+    Pricing<TieredPrice, MemberDiscount, PriceCap>>;
+
+// a quote priced through a compile-time policy instead of a virtual function
+class PolicyQuote {
+public:
+    PolicyQuote() = default;
+    PolicyQuote(const std::string &book, Money sales_price, PricePolicy p):
+            bookNo(book), key(book), price(sales_price), policy(std::move(p)) { }
+    // the same quote as a Quote or Bulk_quote; other derived types are not known here
+    explicit PolicyQuote(const Quote &q);
+
+    const std::string &isbn() const { return bookNo; }
+    Isbn isbn_key() const { return key; }
+    Money net_price(std::size_t n) const {
+        return std::visit([&](const auto &p) { return p.net(n, price); }, policy);
+    }
+private:
+    std::string bookNo;
+    Isbn key;
+    Money price;
+    PricePolicy policy;
+};
+
+inline PolicyQuote::PolicyQuote(const Quote &q):
+        bookNo(q.isbn()), key(q.isbn_key()), price(q.base_price())
+{
+    if (typeid(q) == typeid(Quote))
+        policy = Pricing<FlatPrice>{};
+    else if (typeid(q) == typeid(Bulk_quote)) {
+        auto &b = static_cast<const Bulk_quote&>(q);
+        policy = Pricing<BulkPrice>{{b.min_quantity(), b.discount_rate()}, {}};
+    } else
+        throw std::invalid_argument("no pricing policy for " + std::string(typeid(q).name()));
+}
+
+// adapter the other way round: a policy-priced book that is a Quote, so it can go into a
+// Basket or anywhere else a Quote is expected
+template <typename P> class Policy_quote : public Quote {
+public:
+    Policy_quote() = default;
+    Policy_quote(const std::string &book, Money p, P pol):
+            Quote(book, p), policy(std::move(pol)) { }
+    Money net_price(std::size_t n) const override { return policy.net(n, price); }
+    Policy_quote* clone() const & override { return new Policy_quote(*this); }
+    Policy_quote* clone() && override { return new Policy_quote(std::move(*this)); }
+    std::shared_ptr<Quote> clone_shared() const & override
+    {
+        return std::allocate_shared<Policy_quote>(PoolAllocator<Policy_quote>(), *this);
+    }
+    std::shared_ptr<Quote> clone_shared() && override
+    {
+        return std::allocate_shared<Policy_quote>(PoolAllocator<Policy_quote>(), std::move(*this));
+    }
+private:
+    P policy;
+};
+
+#endif
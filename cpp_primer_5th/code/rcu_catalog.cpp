@@ -0,0 +1,121 @@
+#include "rcu_catalog.h"
+
+using namespace std;
+
+// usage: rcu_catalog [updates_per_second]; prices baskets from 1..hardware_concurrency
+// reader threads while one writer reprices books at a steady rate, first against a
+// catalog guarded by a shared_mutex, then against an RcuCatalog
+
+// catalog whose readers and writer share a reader-writer lock, for comparison
+class LockedCatalog {
+public:
+    explicit LockedCatalog(const vector<shared_ptr<const Quote>> &quotes) {
+        for (auto &q : quotes)
+            m[q->isbn_key()] = q;
+    }
+    Money total(const vector<pair<Isbn, size_t>> &lines) const {
+        shared_lock<shared_mutex> lock(mtx);
+        Money sum;
+        for (auto &l : lines) {
+            auto it = m.find(l.first);
+            if (it != m.end())
+                sum += it->second->net_price(l.second);
+        }
+        return sum;
+    }
+    void update(const vector<shared_ptr<const Quote>> &changes) {
+        unique_lock<shared_mutex> lock(mtx);
+        for (auto &q : changes)
+            m[q->isbn_key()] = q;
+    }
+private:
+    mutable shared_mutex mtx;
+    unordered_map<Isbn, shared_ptr<const Quote>> m;
+};
+
+const size_t nbooks = 5000;
+
+shared_ptr<const Quote> make_book(size_t i, Money price)
+{
+    return make_shared<Bulk_quote>("book-" + to_string(i), price, 20, .1);
+}
+
+// readers price 10-line baskets for a fixed time while the writer changes 10 prices per
+// update, rate times a second; returns baskets priced per second over all readers
+template <typename Catalog> double baskets_per_second(Catalog &cat, unsigned threads, double rate)
+{
+    vector<Isbn> keys; // made up front: interning takes a lock
+    for (size_t i = 0; i != nbooks; ++i)
+        keys.emplace_back("book-" + to_string(i));
+    atomic<bool> stop{false};
+    atomic<size_t> priced{0};
+    vector<thread> readers;
+    for (unsigned t = 0; t != threads; ++t)
+        readers.emplace_back([&, t] {
+            mt19937 gen(t);
+            vector<pair<Isbn, size_t>> lines(10);
+            size_t n = 0;
+            Money sink;
+            while (!stop.load(memory_order_relaxed)) {
+                for (auto &l : lines)
+                    l = {keys[gen() % nbooks], 1 + gen() % 30};
+                sink += cat.total(lines);
+                ++n;
+            }
+            priced += n + (sink < Money()); // use sink so the pricing is not optimized away
+        });
+    thread writer([&] {
+        mt19937 gen(42);
+        auto period = chrono::duration<double>(1 / rate);
+        auto next = chrono::steady_clock::now();
+        while (!stop.load(memory_order_relaxed)) {
+            vector<shared_ptr<const Quote>> changes;
+            for (int i = 0; i != 10; ++i)
+                changes.push_back(make_book(gen() % nbooks, Money(10 + gen() % 40)));
+            cat.update(changes);
+            next += chrono::duration_cast<chrono::steady_clock::duration>(period);
+            this_thread::sleep_until(next);
+        }
+    });
+    const double seconds = 0.5;
+    this_thread::sleep_for(chrono::duration<double>(seconds));
+    stop = true;
+    for (auto &r : readers)
+        r.join();
+    writer.join();
+    return priced / seconds;
+}
+
+int main(int argc, char *argv[]) {
+    double rate = argc > 1 ? stod(argv[1]) : 1000;
+    vector<shared_ptr<const Quote>> books;
+    for (size_t i = 0; i != nbooks; ++i)
+        books.push_back(make_book(i, Money(10 + i % 40)));
+
+    // a price change is seen by the next reader, while the old version stays intact
+    // for readers that are still using it
+    RcuCatalog cat(books);
+    auto key = Isbn("book-7");
+    cout << "book-7 x 25: " << *cat.net_price(key, 25);
+    cat.read([&](const RcuCatalog::Version &v) {
+        auto before = v.find(key); // stays valid until this read section ends
+        cat.update({make_book(7, Money(99))});
+        cout << ", repriced to " << *cat.net_price(key, 25)
+             << ", still " << before->net_price(25) << " for the reader that started earlier"
+             << endl;
+        return 0;
+    });
+    cat.update({}); // the grace period of the first update is over now
+    cout << "versions waiting to be freed: " << cat.retired_count() << endl;
+
+    unsigned max_threads = max(1u, thread::hardware_concurrency());
+    for (unsigned threads = 1; threads <= max_threads; threads *= 2) {
+        LockedCatalog locked(books);
+        RcuCatalog rcu(books);
+        double a = baskets_per_second(locked, threads, rate);
+        double b = baskets_per_second(rcu, threads, rate);
+        cout << threads << " readers, " << rate << " updates/s: shared_mutex "
+             << a / 1e6 << " M baskets/s, RCU " << b / 1e6 << " M baskets/s" << endl;
+    }
+    return 0;
+}
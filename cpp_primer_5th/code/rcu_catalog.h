@@ -0,0 +1,212 @@
+#ifndef RCU_CATALOG_H
+#define RCU_CATALOG_H
+
+#include <bits/stdc++.h>
+#include "isbn_table.h"
+#include "quote.h"
+
+// epoch-based read-copy-update
+// a reader announces the global epoch in its own slot while it uses shared data and clears
+// the slot afterwards; it never takes a lock or writes to memory other threads write
+// a writer publishes a new version with one atomic exchange, bumps the epoch and retires
+// the old version tagged with the epoch it replaced; the version is freed once no reader
+// slot holds an epoch at or below that tag, i.e. after every reader that could have seen
+// it has left (the grace period)
+class RcuDomain {
+public:
+    static RcuDomain &instance() {
+        static RcuDomain d;
+        return d;
+    }
+    // read-side critical section; sections may nest, only the outermost one counts
+    void read_lock() {
+        auto &r = me();
+        if (r.depth++ == 0)
+            r.slot->epoch.store(epoch.load(), std::memory_order_seq_cst);
+    }
+    void read_unlock() {
+        auto &r = me();
+        if (--r.depth == 0)
+            r.slot->epoch.store(0, std::memory_order_release);
+    }
+    // start a new epoch; returns the one that just ended
+    std::uint64_t advance() { return epoch.fetch_add(1); }
+    // true once no reader can still be inside a section that began in epoch e or earlier
+    // a block added after the list is read belongs to a reader that will see a later epoch
+    bool grace_period_over(std::uint64_t e) const {
+        for (auto b = blocks.load(std::memory_order_seq_cst); b; b = b->next)
+            for (auto &s : b->slots) {
+                auto v = s.epoch.load(std::memory_order_seq_cst);
+                if (v != 0 && v <= e)
+                    return false;
+            }
+        return true;
+    }
+private:
+    struct alignas(64) Slot { // one cache line per reader, so readers never share a line
+        std::atomic<std::uint64_t> epoch{0}; // 0: not reading
+        std::atomic<bool> used{false};
+    };
+    // the slots come in blocks on a list that only grows, so there is no limit on readers
+    // and a slot never moves while its thread uses it
+    struct Block {
+        std::array<Slot, 64> slots;
+        Block *next = nullptr;
+    };
+    // claims a slot the first time a thread reads and frees it when the thread exits
+    struct Registration {
+        Slot *slot = nullptr;
+        unsigned depth = 0; // read sections this thread has open
+        explicit Registration(RcuDomain &d): slot(d.claim()) { }
+        ~Registration() { slot->used.store(false, std::memory_order_release); }
+    };
+    Registration &me() {
+        static thread_local Registration r(*this);
+        return r;
+    }
+    Slot *claim() {
+        auto head = blocks.load(std::memory_order_acquire);
+        for (auto b = head; b; b = b->next)
+            for (auto &s : b->slots) {
+                bool expected = false;
+                if (s.used.compare_exchange_strong(expected, true))
+                    return &s;
+            }
+        // every slot is taken: add a block with this thread in its first slot
+        auto b = new Block;
+        b->slots[0].used.store(true, std::memory_order_relaxed);
+        b->next = head;
+        while (!blocks.compare_exchange_weak(b->next, b, std::memory_order_seq_cst))
+            ;
+        return &b->slots[0];
+    }
+    std::atomic<std::uint64_t> epoch{1};
+    std::atomic<Block*> blocks{new Block}; // never freed: threads may read until the process ends
+};
+
+// holds an RCU read-side critical section open for its lifetime
+class RcuReadGuard {
+public:
+    RcuReadGuard() { RcuDomain::instance().read_lock(); }
+    ~RcuReadGuard() { RcuDomain::instance().read_unlock(); }
+    RcuReadGuard(const RcuReadGuard&) = delete;
+    RcuReadGuard &operator=(const RcuReadGuard&) = delete;
+};
+
+// quotes by ISBN that can be repriced while readers are pricing
+// every version is immutable: a reader works on whichever version was current when it
+// started, and writers copy the current version, apply their changes and publish the copy
+// a version is an IsbnTable, so that copying it is two array copies
+class RcuCatalog {
+public:
+    class Version {
+    public:
+        std::size_t size() const { return quotes.size(); }
+        // the quote for key, or nullptr; valid until the read section ends
+        const Quote *find(Isbn key) const {
+            auto q = quotes.find(key);
+            return q ? q->get() : nullptr;
+        }
+    private:
+        friend class RcuCatalog;
+        IsbnTable<std::shared_ptr<const Quote>> quotes;
+    };
+
+    explicit RcuCatalog(const std::vector<std::shared_ptr<const Quote>> &quotes = {});
+    ~RcuCatalog();
+    RcuCatalog(const RcuCatalog&) = delete;
+    RcuCatalog &operator=(const RcuCatalog&) = delete;
+
+    // readers: run f(const Version&) on the current version without taking a lock
+    // the load is seq_cst like the slot store before it and the writer's exchange and slot
+    // scan; an acquire load could move above the slot store (stlr + ldapr on ARM), and the
+    // writer could then see the slot empty and free the version this reader loads
+    template <typename F> auto read(F f) const {
+        RcuReadGuard guard;
+        return f(*current.load(std::memory_order_seq_cst));
+    }
+    // net price of n copies at the current price; empty if the book is not listed
+    std::optional<Money> net_price(Isbn key, std::size_t n) const;
+    // total of several (book, copies) lines, all priced against the same version
+    Money total(const std::vector<std::pair<Isbn, std::size_t>> &lines) const;
+
+    // writers: add or replace quotes and delete books, as one atomic change
+    void update(const std::vector<std::shared_ptr<const Quote>> &changes,
+                const std::vector<Isbn> &removals = {});
+    // old versions still waiting for their grace period
+    std::size_t retired_count() const {
+        std::lock_guard<std::mutex> lock(write_mutex);
+        return retired.size();
+    }
+private:
+    void reclaim(); // free the retired versions whose grace period is over
+
+    std::atomic<const Version*> current;
+    mutable std::mutex write_mutex; // writers take turns; readers never touch it
+    std::vector<std::pair<const Version*, std::uint64_t>> retired; // version, epoch it ended
+};
+
+inline RcuCatalog::RcuCatalog(const std::vector<std::shared_ptr<const Quote>> &quotes)
+{
+    std::unique_ptr<Version> v(new Version);
+    for (auto &q : quotes)
+        v->quotes[q->isbn_key()] = q;
+    current.store(v.release());
+}
+
+inline RcuCatalog::~RcuCatalog()
+{
+    // no reader may still be using the catalog when it is destroyed
+    delete current.load();
+    for (auto &r : retired)
+        delete r.first;
+}
+
+inline std::optional<Money> RcuCatalog::net_price(Isbn key, std::size_t n) const
+{
+    return read([&](const Version &v) {
+        auto q = v.find(key);
+        return q ? std::optional<Money>(q->net_price(n)) : std::nullopt;
+    });
+}
+
+inline Money RcuCatalog::total(const std::vector<std::pair<Isbn, std::size_t>> &lines) const
+{
+    return read([&](const Version &v) {
+        Money sum;
+        for (auto &l : lines)
+            if (auto q = v.find(l.first))
+                sum += q->net_price(l.second);
+        return sum;
+    });
+}
+
+inline void RcuCatalog::update(const std::vector<std::shared_ptr<const Quote>> &changes,
+                               const std::vector<Isbn> &removals)
+{
+    std::lock_guard<std::mutex> lock(write_mutex);
+    std::unique_ptr<Version> next(new Version(*current.load()));
+    for (auto &q : changes)
+        next->quotes[q->isbn_key()] = q;
+    for (auto k : removals)
+        next->quotes.erase(k);
+    auto old = current.exchange(next.release());
+    // readers that saw an epoch up to this one may still hold old
+    retired.emplace_back(old, RcuDomain::instance().advance());
+    reclaim();
+}
+
+inline void RcuCatalog::reclaim()
+{
+    auto &d = RcuDomain::instance();
+    auto keep = std::remove_if(retired.begin(), retired.end(),
+                               [&](const std::pair<const Version*, std::uint64_t> &r) {
+        if (!d.grace_period_over(r.second))
+            return false;
+        delete r.first;
+        return true;
+    });
+    retired.erase(keep, retired.end());
+}
+
+#endif
@@ -0,0 +1,175 @@
+#ifndef RECEIPT_WRITER_H
+#define RECEIPT_WRITER_H
+
+#include <bits/stdc++.h>
+#include <unistd.h>
+#include "money.h"
+
+enum class ReceiptFormat {
+    text, // the same lines print_total writes
+    csv, // isbn,sold,total rows after a header row
+    json // {"lines":[{"isbn":...,"sold":...,"total":...}],"total":...}
+};
+
+// formats a receipt into one reusable buffer and emits it with a single write
+// numbers go through to_chars; amounts are written with exactly two decimals (see money.h)
+class ReceiptWriter {
+public:
+    explicit ReceiptWriter(ReceiptFormat f = ReceiptFormat::text): format(f) { }
+
+    void line(const std::string &isbn, std::size_t sold, Money total_due);
+    void finish(Money total); // the closing "Total Sale" line, row or member
+    const std::string &str() const { return buf; }
+    // emit the receipt and empty the buffer, keeping its capacity for the next receipt
+    void write_to(std::ostream &os);
+    void write_to(int fd);
+    void clear() { buf.clear(); lines = 0; }
+private:
+    void put(std::size_t n);
+    void put(Money m);
+    void put_quoted(const std::string &s); // CSV or JSON string
+    void start(); // header row or opening of the json object, before the first line
+
+    ReceiptFormat format;
+    std::string buf;
+    std::size_t lines = 0; // lines written since clear()
+};
+
+inline void ReceiptWriter::put(std::size_t n)
+{
+    char tmp[24];
+    auto r = std::to_chars(tmp, tmp + sizeof(tmp), n);
+    buf.append(tmp, r.ptr);
+}
+
+inline void ReceiptWriter::put(Money m)
+{
+    char tmp[24];
+    auto r = to_chars(tmp, tmp + sizeof(tmp), m);
+    buf.append(tmp, r.ptr);
+}
+
+inline void ReceiptWriter::put_quoted(const std::string &s)
+{
+    if (format == ReceiptFormat::csv) {
+        // RFC 4180: only fields with separators or quotes need quoting
+        if (s.find_first_of(",\"\r\n") == std::string::npos) {
+            buf += s;
+            return;
+        }
+        buf += '"';
+        for (char c : s) {
+            if (c == '"')
+                buf += '"';
+            buf += c;
+        }
+        buf += '"';
+        return;
+    }
+    buf += '"';
+    for (unsigned char c : s) {
+        if (c == '"' || c == '\\') {
+            buf += '\\';
+            buf += c;
+        } else if (c < 0x20) {
+            char tmp[8];
+            std::snprintf(tmp, sizeof(tmp), "\\u%04x", c);
+            buf += tmp;
+        } else {
+            buf += c;
+        }
+    }
+    buf += '"';
+}
+
+inline void ReceiptWriter::start()
+{
+    if (format == ReceiptFormat::csv)
+        buf += "isbn,sold,total\n";
+    else if (format == ReceiptFormat::json)
+        buf += "{\"lines\":[";
+}
+
+inline void ReceiptWriter::line(const std::string &isbn, std::size_t sold, Money total_due)
+{
+    if (lines++ == 0)
+        start();
+    switch (format) {
+    case ReceiptFormat::text:
+        buf += "ISBN: ";
+        buf += isbn;
+        buf += " # sold: ";
+        put(sold);
+        buf += " total due: ";
+        put(total_due);
+        buf += '\n';
+        break;
+    case ReceiptFormat::csv:
+        put_quoted(isbn);
+        buf += ',';
+        put(sold);
+        buf += ',';
+        put(total_due);
+        buf += '\n';
+        break;
+    case ReceiptFormat::json:
+        if (lines > 1)
+            buf += ',';
+        buf += "{\"isbn\":";
+        put_quoted(isbn);
+        buf += ",\"sold\":";
+        put(sold);
+        buf += ",\"total\":";
+        put(total_due);
+        buf += '}';
+        break;
+    }
+}
+
+inline void ReceiptWriter::finish(Money total)
+{
+    if (lines == 0)
+        start();
+    switch (format) {
+    case ReceiptFormat::text:
+        buf += "Total Sale: ";
+        put(total);
+        buf += '\n';
+        break;
+    case ReceiptFormat::csv:
+        buf += "total,,";
+        put(total);
+        buf += '\n';
+        break;
+    case ReceiptFormat::json:
+        buf += "],\"total\":";
+        put(total);
+        buf += "}\n";
+        break;
+    }
+}
+
+inline void ReceiptWriter::write_to(std::ostream &os)
+{
+    os.write(buf.data(), buf.size());
+    clear();
+}
+
+inline void ReceiptWriter::write_to(int fd)
+{
+    const char *p = buf.data();
+    std::size_t left = buf.size();
+    while (left) {
+        auto n = ::write(fd, p, left);
+        if (n < 0) {
+            if (errno == EINTR)
+                continue;
+            throw std::system_error(errno, std::generic_category(), "write");
+        }
+        p += n;
+        left -= n;
+    }
+    clear();
+}
+
+#endif
@@ -0,0 +1,30 @@
+#include "sorted_strvec.h"
+
+using namespace std;
+
+int main() {
+    StrVec ids;
+    for (auto s : {"push_back", "size", "capacity", "begin", "end", "size",
+                   "reallocate", "reallocate_n", "alloc_n_copy", "free"})
+        ids.push_back(s);
+    SortedStrVec sorted(ids); // sorted, duplicates removed
+    for (auto &s : sorted)
+        cout << s << " ";
+    cout << endl;
+    cout << sorted.contains("reallocate") << " " << sorted.contains("realloc") << endl;
+
+    StrVec more;
+    for (auto s : {"begin", "cbegin", "cend", "end", "free"})
+        more.push_back(s);
+    SortedStrVec other(more);
+    for (auto &s : set_union(sorted, other))
+        cout << s << " ";
+    cout << endl;
+    for (auto &s : set_intersection(sorted, other))
+        cout << s << " ";
+    cout << endl;
+    for (auto &s : set_difference(sorted, other))
+        cout << s << " ";
+    cout << endl;
+    return 0;
+}
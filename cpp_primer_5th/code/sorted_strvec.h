@@ -0,0 +1,205 @@
+#ifndef SORTED_STRVEC_H
+#define SORTED_STRVEC_H
+
+#include <bits/stdc++.h>
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#endif
+#include "vec.h"
+
+// sorted, duplicate-free companion of StrVec
+// next to the strings we keep keys[i]: the first 8 bytes of elements[i] packed big-endian
+// (zero padded), so comparing two keys as unsigned integers orders the strings the same
+// way string::compare does; full strings are only compared when the keys are equal
+class SortedStrVec {
+public:
+    SortedStrVec() = default;
+    explicit SortedStrVec(const StrVec&); // sorts and removes duplicates
+
+    std::size_t size() const { return elements.size(); }
+    bool empty() const { return elements.empty(); }
+    const std::string *begin() const { return elements.begin(); }
+    const std::string *end() const { return elements.end(); }
+    const std::string &operator[](std::size_t i) const { return elements[i]; }
+
+    // index of the first element not less than s
+    std::size_t lower_bound(const std::string&) const;
+    // index of s, or size() if s is not present
+    std::size_t find(const std::string &s) const {
+        auto i = lower_bound(s);
+        return i != size() && elements[i] == s ? i : size();
+    }
+    bool contains(const std::string &s) const { return find(s) != size(); }
+
+    // set operations; both operands are sorted, so each runs in one linear merge
+    friend SortedStrVec set_union(const SortedStrVec&, const SortedStrVec&);
+    friend SortedStrVec set_intersection(const SortedStrVec&, const SortedStrVec&);
+    friend SortedStrVec set_difference(const SortedStrVec&, const SortedStrVec&);
+
+    static std::uint64_t prefix_key(const std::string&);
+private:
+    // windows at most this long are scanned linearly (with SIMD when available)
+    static constexpr std::size_t scan_window = 16;
+
+    // -1, 0 or 1 as element i is less than, equal to or greater than (s, key)
+    int compare_at(std::size_t i, const std::string &s, std::uint64_t key) const {
+        if (keys[i] != key)
+            return keys[i] < key ? -1 : 1;
+        int r = elements[i].compare(s);
+        return (r > 0) - (r < 0);
+    }
+    // first index in [b, b + n) whose key is not less than key
+    std::size_t scan_keys(std::size_t b, std::size_t n, std::uint64_t key) const;
+    // append s, which must not be less than the current last element
+    void append(const std::string &s, std::uint64_t key) {
+        elements.push_back(s);
+        keys.push_back(key);
+    }
+
+    StrVec elements;
+    Vec<std::uint64_t> keys;
+};
+
+inline std::uint64_t SortedStrVec::prefix_key(const std::string &s)
+{
+    std::uint64_t key = 0;
+    auto n = std::min<std::size_t>(s.size(), 8);
+    for (std::size_t i = 0; i != 8; ++i)
+        key = (key << 8) | (i < n ? static_cast<unsigned char>(s[i]) : 0);
+    return key;
+}
+
+inline SortedStrVec::SortedStrVec(const StrVec &sv)
+{
+    std::vector<const std::string*> order;
+    order.reserve(sv.size());
+    for (auto p = sv.begin(); p != sv.end(); ++p)
+        order.push_back(p);
+    std::sort(order.begin(), order.end(),
+              [](const std::string *a, const std::string *b) { return *a < *b; });
+    // equal strings are adjacent after sorting, so dedup is a single pass
+    for (std::size_t i = 0; i != order.size(); ++i)
+        if (i == 0 || *order[i] != *order[i - 1])
+            append(*order[i], prefix_key(*order[i]));
+}
+
+#if defined(__x86_64__) || defined(__i386__)
+// index of the first of keys[0, n) that is >= key, or n; the keys are sorted
+// built for AVX2 whatever the compiler flags; only called when the CPU has it
+__attribute__((target("avx2")))
+inline std::size_t scan_keys_avx2(const std::uint64_t *keys, std::size_t n, std::uint64_t key)
+{
+    // AVX2 only has a signed 64-bit compare; flipping the sign bit makes it unsigned
+    const __m256i flip = _mm256_set1_epi64x(static_cast<long long>(1ULL << 63));
+    const __m256i k = _mm256_xor_si256(_mm256_set1_epi64x(static_cast<long long>(key)), flip);
+    std::size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(keys + i));
+        // lanes where key > keys[j], i.e. keys[j] is still too small
+        __m256i lt = _mm256_cmpgt_epi64(k, _mm256_xor_si256(v, flip));
+        unsigned mask = _mm256_movemask_pd(_mm256_castsi256_pd(lt));
+        if (mask != 0xf) // keys are sorted, so the first clear lane is the answer
+            return i + __builtin_ctz(~mask);
+    }
+    for (; i != n; ++i)
+        if (keys[i] >= key)
+            break;
+    return i;
+}
+#endif
+
+inline std::size_t
+SortedStrVec::scan_keys(std::size_t b, std::size_t n, std::uint64_t key) const
+{
+#if defined(__x86_64__) || defined(__i386__)
+    // picked when the program runs, as in pricing.h, so plain builds use it too
+    static const bool avx2 = __builtin_cpu_supports("avx2");
+    if (avx2)
+        return b + scan_keys_avx2(keys.begin() + b, n, key);
+#endif
+    std::size_t i = 0;
+    for (; i != n; ++i)
+        if (keys[b + i] >= key)
+            break;
+    return b + i;
+}
+
+inline std::size_t SortedStrVec::lower_bound(const std::string &s) const
+{
+    auto key = prefix_key(s);
+    // branch-free binary search over the key array until the window is small
+    std::size_t lo = 0, n = size();
+    while (n > scan_window) {
+        auto half = n / 2;
+        lo = keys[lo + half - 1] < key ? lo + half : lo;
+        n -= half;
+    }
+    auto i = scan_keys(lo, n, key);
+    if (i == size() || keys[i] != key)
+        return i;
+    // elements sharing the prefix are ordered by the rest of the string; such runs can be
+    // long (mangled names, "std::__cxx11::..."), so binary-search them with full compares
+    n = size() - i;
+    while (n > 0) {
+        auto half = n / 2;
+        if (compare_at(i + half, s, key) < 0) {
+            i += half + 1;
+            n -= half + 1;
+        } else {
+            n = half;
+        }
+    }
+    return i;
+}
+
+inline SortedStrVec set_union(const SortedStrVec &a, const SortedStrVec &b)
+{
+    SortedStrVec ret;
+    std::size_t i = 0, j = 0;
+    while (i != a.size() && j != b.size()) {
+        int c = a.compare_at(i, b.elements[j], b.keys[j]);
+        if (c < 0) {
+            ret.append(a.elements[i], a.keys[i]);
+            ++i;
+        } else {
+            ret.append(b.elements[j], b.keys[j]);
+            i += c == 0;
+            ++j;
+        }
+    }
+    for (; i != a.size(); ++i)
+        ret.append(a.elements[i], a.keys[i]);
+    for (; j != b.size(); ++j)
+        ret.append(b.elements[j], b.keys[j]);
+    return ret;
+}
+
+inline SortedStrVec set_intersection(const SortedStrVec &a, const SortedStrVec &b)
+{
+    SortedStrVec ret;
+    std::size_t i = 0, j = 0;
+    while (i != a.size() && j != b.size()) {
+        int c = a.compare_at(i, b.elements[j], b.keys[j]);
+        if (c == 0)
+            ret.append(a.elements[i], a.keys[i]);
+        i += c <= 0;
+        j += c >= 0;
+    }
+    return ret;
+}
+
+inline SortedStrVec set_difference(const SortedStrVec &a, const SortedStrVec &b)
+{
+    SortedStrVec ret;
+    std::size_t i = 0, j = 0;
+    while (i != a.size()) {
+        int c = j == b.size() ? -1 : a.compare_at(i, b.elements[j], b.keys[j]);
+        if (c < 0)
+            ret.append(a.elements[i], a.keys[i]);
+        i += c <= 0;
+        j += c >= 0;
+    }
+    return ret;
+}
+
+#endif
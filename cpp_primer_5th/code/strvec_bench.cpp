@@ -0,0 +1,146 @@
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include "vec.h"
+
+using namespace std;
+
+// usage: strvec_bench [count] [--max-ratio r]
+// times push_back, copy, iteration and destruction of StrVec and vector<string> for
+// several string-length distributions; with --max-ratio the program fails if any StrVec
+// operation is more than r times slower than the vector one, so it can guard changes
+
+// every allocation made through operator new is counted
+static atomic<size_t> allocations{0};
+
+void *operator new(size_t n)
+{
+    allocations.fetch_add(1, memory_order_relaxed);
+    if (auto p = malloc(n ? n : 1))
+        return p;
+    throw bad_alloc();
+}
+void operator delete(void *p) noexcept { free(p); }
+void operator delete(void *p, size_t) noexcept { free(p); }
+
+// last-level cache misses of this thread, read through perf_event_open;
+// reports -1 where perf events are not available (containers, paranoid kernels)
+class CacheMisses {
+public:
+    CacheMisses() {
+        perf_event_attr attr{};
+        attr.type = PERF_TYPE_HARDWARE;
+        attr.size = sizeof(attr);
+        attr.config = PERF_COUNT_HW_CACHE_MISSES;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        fd = static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0));
+    }
+    ~CacheMisses() { if (fd >= 0) close(fd); }
+    void start() { if (fd >= 0) { ioctl(fd, PERF_EVENT_IOC_RESET, 0); ioctl(fd, PERF_EVENT_IOC_ENABLE, 0); } }
+    long long stop() {
+        long long n = -1;
+        if (fd >= 0) {
+            ioctl(fd, PERF_EVENT_IOC_DISABLE, 0);
+            if (read(fd, &n, sizeof(n)) != sizeof(n))
+                n = -1;
+        }
+        return n;
+    }
+private:
+    int fd;
+};
+
+struct Result {
+    double ns_per_op;
+    size_t allocs;
+    long long misses;
+};
+
+// run f once and measure it
+template <typename F> Result measure(size_t ops, F f)
+{
+    static CacheMisses counter;
+    auto allocs = allocations.load();
+    counter.start();
+    auto start = chrono::steady_clock::now();
+    f();
+    auto stop = chrono::steady_clock::now();
+    auto misses = counter.stop();
+    return {chrono::duration<double, nano>(stop - start).count() / (ops ? ops : 1),
+            allocations.load() - allocs, misses};
+}
+
+// push, copy, iterate and destroy one container type over the given strings
+template <typename C> map<string, Result> run(const vector<string> &input)
+{
+    map<string, Result> res;
+    unique_ptr<C> c(new C), copy;
+    res["push"] = measure(input.size(), [&] {
+        for (auto &s : input)
+            c->push_back(s);
+    });
+    res["copy"] = measure(input.size(), [&] { copy.reset(new C(*c)); });
+    size_t total = 0;
+    res["iterate"] = measure(input.size(), [&] {
+        for (auto p = copy->begin(); p != copy->end(); ++p)
+            total += p->size();
+    });
+    res["destroy"] = measure(input.size(), [&] { c.reset(); copy.reset(); });
+    if (total == 1) // keep the iteration from being optimized away
+        cout << "";
+    return res;
+}
+
+// strings whose lengths follow the named distribution
+vector<string> make_input(const string &dist, size_t n)
+{
+    mt19937 gen(42);
+    geometric_distribution<size_t> geo(1.0 / 24);
+    vector<string> ret;
+    ret.reserve(n);
+    for (size_t i = 0; i != n; ++i) {
+        size_t len = dist == "sso(8)" ? 8 : dist == "medium(32)" ? 32 :
+                     dist == "long(256)" ? 256 : geo(gen);
+        ret.emplace_back(len, static_cast<char>('a' + i % 26));
+    }
+    return ret;
+}
+
+int main(int argc, char *argv[]) {
+    size_t n = 1000000;
+    double max_ratio = 0;
+    for (int i = 1; i < argc; ++i) {
+        if (string(argv[i]) == "--max-ratio" && i + 1 < argc)
+            max_ratio = stod(argv[++i]);
+        else
+            n = stoul(argv[i]);
+    }
+
+    bool ok = true;
+    cout << left << setw(12) << "strings" << setw(9) << "op"
+         << setw(26) << "StrVec ns/op allocs miss" << "vector ns/op allocs miss" << endl;
+    for (string dist : {"sso(8)", "medium(32)", "long(256)", "geometric"}) {
+        auto input = make_input(dist, n);
+        // the first round only warms up the heap; its page faults would swamp the numbers
+        run<StrVec>(input);
+        run<vector<string>>(input);
+        auto mine = run<StrVec>(input);
+        auto theirs = run<vector<string>>(input);
+        for (string op : {"push", "copy", "iterate", "destroy"}) {
+            auto &a = mine[op], &b = theirs[op];
+            ostringstream lhs;
+            lhs << fixed << setprecision(2) << a.ns_per_op << " " << a.allocs << " " << a.misses;
+            cout << setw(12) << dist << setw(9) << op << setw(26) << lhs.str()
+                 << fixed << setprecision(2) << b.ns_per_op << " " << b.allocs << " " << b.misses;
+            // sub-nanosecond timings are too noisy to compare
+            if (max_ratio > 0 && b.ns_per_op > 1 && a.ns_per_op > max_ratio * b.ns_per_op) {
+                cout << "  <-- slower than " << max_ratio << "x";
+                ok = false;
+            }
+            cout << endl;
+        }
+    }
+    return ok ? 0 : 1;
+}
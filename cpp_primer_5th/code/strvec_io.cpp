@@ -0,0 +1,34 @@
+#include <fcntl.h>
+#include "strvec_io.h"
+
+using namespace std;
+
+// usage: strvec_io [count]; writes count strings to strvec.dat and reads them back
+int main(int argc, char *argv[]) {
+    size_t n = argc > 1 ? stoul(argv[1]) : 1000000;
+    StrVec svec;
+    svec.reserve(n);
+    for (size_t i = 0; i != n; ++i)
+        svec.push_back("symbol_" + to_string(i * 2654435761u % 1000003));
+    svec.push_back(string(1000, 'x')); // long enough to be written without copying
+
+    auto start = chrono::steady_clock::now();
+    int fd = open("strvec.dat", O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    serialize(svec, fd);
+    close(fd);
+    auto mid = chrono::steady_clock::now();
+    fd = open("strvec.dat", O_RDONLY);
+    StrVec back = deserialize(fd);
+    close(fd);
+    auto stop = chrono::steady_clock::now();
+
+    struct stat st;
+    stat("strvec.dat", &st);
+    auto mb = st.st_size / 1e6;
+    chrono::duration<double> save = mid - start, load = stop - mid;
+    cout << back.size() << " strings, " << mb << " MB" << endl;
+    cout << "save: " << mb / save.count() << " MB/s, load: " << mb / load.count() << " MB/s" << endl;
+    cout << (equal(svec.begin(), svec.end(), back.begin(), back.end()) ? "ok" : "mismatch") << endl;
+    remove("strvec.dat");
+    return 0;
+}
@@ -0,0 +1,201 @@
+#ifndef STRVEC_IO_H
+#define STRVEC_IO_H
+
+#include <bits/stdc++.h>
+#include <sys/stat.h>
+#include <sys/uio.h>
+#include <unistd.h>
+#include "vec.h"
+
+// binary stream format of a StrVec:
+//   "STRVS001" | uint64_t count | for each string: LEB128 length, then its characters
+// serialize gathers the stream with writev: short strings are copied into a staging
+// buffer next to their lengths, long strings are written straight from the StrVec
+// deserialize reads the whole stream with one bulk read and constructs each string
+// in place from the buffer
+
+constexpr char strvec_stream_magic[8] = {'S', 'T', 'R', 'V', 'S', '0', '0', '1'};
+
+class StrVecWriter {
+public:
+    explicit StrVecWriter(int fd): fd(fd) { }
+    void put(const void *p, std::size_t n); // copy n bytes into the staging buffer
+    void put_varint(std::uint64_t v);
+    void put_string(const std::string &s);
+    void flush(); // hand everything gathered so far to writev
+private:
+    // strings at least this long get an iovec of their own instead of being copied
+    static constexpr std::size_t copy_limit = 256;
+    // flush once this much has been gathered or the iovec limit is reached
+    static constexpr std::size_t batch_bytes = std::size_t(1) << 20;
+    static constexpr std::size_t batch_iovs = 512;
+
+    // a piece of output: either bytes of buf starting at offset, or external memory
+    struct Piece {
+        const char *ext; // nullptr for staged bytes
+        std::size_t off, len;
+    };
+    void add_piece(const char *ext, std::size_t off, std::size_t len);
+
+    int fd;
+    std::vector<char> buf; // staged bytes; may move as it grows, hence the offsets
+    std::vector<Piece> pieces;
+    std::size_t pending = 0; // bytes gathered since the last flush
+};
+
+inline void StrVecWriter::add_piece(const char *ext, std::size_t off, std::size_t len)
+{
+    // consecutive staged bytes share one piece
+    if (!ext && !pieces.empty() && !pieces.back().ext)
+        pieces.back().len += len;
+    else
+        pieces.push_back({ext, off, len});
+    pending += len;
+    if (pending >= batch_bytes || pieces.size() >= batch_iovs)
+        flush();
+}
+
+inline void StrVecWriter::put(const void *p, std::size_t n)
+{
+    auto off = buf.size();
+    buf.insert(buf.end(), static_cast<const char*>(p), static_cast<const char*>(p) + n);
+    add_piece(nullptr, off, n);
+}
+
+inline void StrVecWriter::put_varint(std::uint64_t v)
+{
+    char tmp[10];
+    std::size_t n = 0;
+    do {
+        tmp[n++] = static_cast<char>((v & 0x7f) | (v > 0x7f ? 0x80 : 0));
+        v >>= 7;
+    } while (v);
+    put(tmp, n);
+}
+
+inline void StrVecWriter::put_string(const std::string &s)
+{
+    put_varint(s.size());
+    if (s.size() < copy_limit)
+        put(s.data(), s.size());
+    else
+        add_piece(s.data(), 0, s.size());
+}
+
+inline void StrVecWriter::flush()
+{
+    std::vector<iovec> iov;
+    iov.reserve(pieces.size());
+    for (auto &p : pieces)
+        iov.push_back({const_cast<char*>(p.ext ? p.ext : buf.data() + p.off), p.len});
+    // writev may write less than asked for; resume where it stopped
+    auto cur = iov.begin();
+    while (cur != iov.end()) {
+        auto cnt = std::min<std::size_t>(iov.end() - cur, IOV_MAX);
+        auto n = writev(fd, &*cur, static_cast<int>(cnt));
+        if (n < 0) {
+            if (errno == EINTR)
+                continue;
+            throw std::system_error(errno, std::generic_category(), "writev");
+        }
+        for (auto left = static_cast<std::size_t>(n); left; ) {
+            if (left >= cur->iov_len) {
+                left -= cur->iov_len;
+                ++cur;
+            } else {
+                cur->iov_base = static_cast<char*>(cur->iov_base) + left;
+                cur->iov_len -= left;
+                left = 0;
+            }
+        }
+        while (cur != iov.end() && cur->iov_len == 0)
+            ++cur;
+    }
+    buf.clear();
+    pieces.clear();
+    pending = 0;
+}
+
+// write sv to the file descriptor fd
+inline void serialize(const StrVec &sv, int fd)
+{
+    StrVecWriter out(fd);
+    out.put(strvec_stream_magic, sizeof(strvec_stream_magic));
+    std::uint64_t count = sv.size();
+    out.put(&count, sizeof(count));
+    for (auto p = sv.begin(); p != sv.end(); ++p)
+        out.put_string(*p);
+    out.flush();
+}
+
+// read the rest of fd into memory; a regular file is read in one piece
+inline std::pair<std::unique_ptr<char[]>, std::size_t> read_all(int fd)
+{
+    std::size_t cap = std::size_t(1) << 16, len = 0;
+    struct stat st;
+    if (fstat(fd, &st) == 0 && S_ISREG(st.st_mode)) {
+        auto pos = lseek(fd, 0, SEEK_CUR);
+        if (pos >= 0 && st.st_size >= pos)
+            cap = st.st_size - pos + 1; // + 1 so that hitting end-of-file needs no regrowth
+    }
+    // new char[] leaves the bytes uninitialized, unlike vector<char>
+    std::unique_ptr<char[]> data(new char[cap]);
+    while (true) {
+        if (len == cap) { // only for pipes or files that grew meanwhile
+            std::unique_ptr<char[]> bigger(new char[cap * 2]);
+            std::memcpy(bigger.get(), data.get(), len);
+            data = std::move(bigger);
+            cap *= 2;
+        }
+        auto n = read(fd, data.get() + len, cap - len);
+        if (n < 0) {
+            if (errno == EINTR)
+                continue;
+            throw std::system_error(errno, std::generic_category(), "read");
+        }
+        if (n == 0)
+            break;
+        len += n;
+    }
+    return {std::move(data), len};
+}
+
+// read a StrVec written by serialize from fd
+inline StrVec deserialize(int fd)
+{
+    auto in = read_all(fd);
+    const char *p = in.first.get(), *end = p + in.second;
+    auto corrupt = [] { return std::runtime_error("corrupt StrVec stream"); };
+
+    std::uint64_t count;
+    if (end - p < static_cast<std::ptrdiff_t>(sizeof(strvec_stream_magic) + sizeof(count)) ||
+        std::memcmp(p, strvec_stream_magic, sizeof(strvec_stream_magic)) != 0)
+        throw corrupt();
+    p += sizeof(strvec_stream_magic);
+    std::memcpy(&count, p, sizeof(count));
+    p += sizeof(count);
+    // every string takes at least one byte, which bounds a sane count
+    if (count > static_cast<std::uint64_t>(end - p))
+        throw corrupt();
+
+    StrVec ret;
+    ret.reserve(count); // a single allocation for the element array
+    for (std::uint64_t i = 0; i != count; ++i) {
+        std::uint64_t len = 0;
+        for (unsigned shift = 0; ; shift += 7) {
+            if (p == end || shift > 63)
+                throw corrupt();
+            auto byte = static_cast<unsigned char>(*p++);
+            len |= std::uint64_t(byte & 0x7f) << shift;
+            if (!(byte & 0x80))
+                break;
+        }
+        if (len > static_cast<std::uint64_t>(end - p))
+            throw corrupt();
+        ret.emplace_back(p, len); // construct the string directly from the buffer
+        p += len;
+    }
+    return ret;
+}
+
+#endif
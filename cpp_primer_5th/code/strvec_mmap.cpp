@@ -0,0 +1,22 @@
+#include "strvec_mmap.h"
+
+using namespace std;
+
+int main() {
+    StrVec svec;
+    svec.push_back("abc");
+    svec.push_back("");
+    svec.push_back("defgh");
+    save_mapped(svec, "strvec.bin");
+
+    // reopening maps the file; nothing is parsed or copied
+    StrVecView view("strvec.bin");
+    cout << view.size() << endl;
+    for (auto s : view)
+        cout << "[" << s << "]" << endl;
+    cout << (find(view.begin(), view.end(), "defgh") - view.begin()) << endl;
+    StrVec copy = view.to_strvec();
+    cout << copy.size() << endl;
+    remove("strvec.bin");
+    return 0;
+}
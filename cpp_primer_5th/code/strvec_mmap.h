@@ -0,0 +1,168 @@
+#ifndef STRVEC_MMAP_H
+#define STRVEC_MMAP_H
+
+#include <bits/stdc++.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "vec.h"
+
+// on-disk layout of a persisted StrVec; every position is an offset, so the file can be
+// mapped at any address:
+//   header | uint64_t offsets[count + 1] | characters of all strings, back to back
+// string i occupies [offsets[i], offsets[i + 1]) of the character area
+struct StrVecFileHeader {
+    char magic[8]; // "STRVEC01"
+    std::uint64_t count; // number of strings
+    std::uint64_t chars; // total size of the character area
+};
+
+constexpr char strvec_file_magic[8] = {'S', 'T', 'R', 'V', 'E', 'C', '0', '1'};
+
+// write the elements of sv to path in the layout above
+inline void save_mapped(const StrVec &sv, const std::string &path)
+{
+    std::vector<std::uint64_t> offsets;
+    offsets.reserve(sv.size() + 1);
+    std::uint64_t pos = 0;
+    offsets.push_back(pos);
+    for (auto p = sv.begin(); p != sv.end(); ++p)
+        offsets.push_back(pos += p->size());
+
+    StrVecFileHeader hdr;
+    std::memcpy(hdr.magic, strvec_file_magic, sizeof(hdr.magic));
+    hdr.count = sv.size();
+    hdr.chars = pos;
+
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    if (!out)
+        throw std::runtime_error("cannot create " + path);
+    out.write(reinterpret_cast<const char*>(&hdr), sizeof(hdr));
+    out.write(reinterpret_cast<const char*>(offsets.data()),
+              offsets.size() * sizeof(std::uint64_t));
+    for (auto p = sv.begin(); p != sv.end(); ++p)
+        out.write(p->data(), p->size());
+    if (!out.flush())
+        throw std::runtime_error("write failed: " + path);
+}
+
+// read-only view of a file written by save_mapped
+// opening only maps the file and checks the header; no string is constructed,
+// elements are handed out as string_views into the mapping
+class StrVecView {
+public:
+    class const_iterator {
+    public:
+        using iterator_category = std::random_access_iterator_tag;
+        using value_type = std::string_view;
+        using difference_type = std::ptrdiff_t;
+        using pointer = void;
+        using reference = std::string_view;
+
+        const_iterator(const StrVecView *v, std::size_t i): view(v), idx(i) { }
+        std::string_view operator*() const { return (*view)[idx]; }
+        std::string_view operator[](difference_type n) const { return (*view)[idx + n]; }
+        const_iterator &operator++() { ++idx; return *this; }
+        const_iterator operator++(int) { auto ret = *this; ++idx; return ret; }
+        const_iterator &operator--() { --idx; return *this; }
+        const_iterator operator--(int) { auto ret = *this; --idx; return ret; }
+        const_iterator &operator+=(difference_type n) { idx += n; return *this; }
+        const_iterator &operator-=(difference_type n) { idx -= n; return *this; }
+        const_iterator operator+(difference_type n) const { return {view, idx + n}; }
+        const_iterator operator-(difference_type n) const { return {view, idx - n}; }
+        difference_type operator-(const const_iterator &rhs) const { return idx - rhs.idx; }
+        bool operator==(const const_iterator &rhs) const { return idx == rhs.idx; }
+        bool operator!=(const const_iterator &rhs) const { return idx != rhs.idx; }
+        bool operator<(const const_iterator &rhs) const { return idx < rhs.idx; }
+    private:
+        const StrVecView *view;
+        std::size_t idx;
+    };
+
+    explicit StrVecView(const std::string &path);
+    StrVecView(const StrVecView&) = delete;
+    StrVecView &operator=(const StrVecView&) = delete;
+    StrVecView(StrVecView &&v) noexcept:
+        base(v.base), length(v.length), offsets(v.offsets), chars(v.chars), nchars(v.nchars), n(v.n) {
+        v.base = nullptr;
+        v.length = v.n = 0;
+    }
+    ~StrVecView() { if (base) munmap(base, length); }
+
+    std::size_t size() const { return n; }
+    bool empty() const { return n == 0; }
+    // the offsets of element i are checked here rather than at open, so a damaged file
+    // throws instead of handing out a view outside the mapping
+    std::string_view operator[](std::size_t i) const {
+        auto b = offsets[i], e = offsets[i + 1];
+        if (b > e || e > nchars)
+            throw std::runtime_error("corrupt StrVec file: bad offsets for element " + std::to_string(i));
+        return {chars + b, static_cast<std::size_t>(e - b)};
+    }
+    const_iterator begin() const { return {this, 0}; }
+    const_iterator end() const { return {this, n}; }
+    // materialize the view as an ordinary StrVec
+    StrVec to_strvec() const;
+private:
+    void *base = nullptr; // start of the mapping
+    std::size_t length = 0; // bytes mapped
+    const std::uint64_t *offsets = nullptr;
+    const char *chars = nullptr;
+    std::uint64_t nchars = 0; // size of the character area
+    std::size_t n = 0;
+};
+
+inline StrVecView::StrVecView(const std::string &path)
+{
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0)
+        throw std::runtime_error("cannot open " + path);
+    struct stat st;
+    if (fstat(fd, &st) < 0 || static_cast<std::size_t>(st.st_size) < sizeof(StrVecFileHeader)) {
+        close(fd);
+        throw std::runtime_error("not a StrVec file: " + path);
+    }
+    length = st.st_size;
+    base = mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd); // the mapping keeps its own reference to the file
+    if (base == MAP_FAILED) {
+        base = nullptr;
+        throw std::runtime_error("mmap failed: " + path);
+    }
+
+    auto hdr = static_cast<const StrVecFileHeader*>(base);
+    // the header must describe exactly the bytes we mapped
+    std::uint64_t need = sizeof(StrVecFileHeader);
+    bool ok = std::memcmp(hdr->magic, strvec_file_magic, sizeof(hdr->magic)) == 0 &&
+              hdr->count < (length - need) / sizeof(std::uint64_t);
+    if (ok) {
+        need += (hdr->count + 1) * sizeof(std::uint64_t) + hdr->chars;
+        ok = need == length;
+    }
+    if (!ok) {
+        munmap(base, length);
+        base = nullptr;
+        throw std::runtime_error("corrupt StrVec file: " + path);
+    }
+    n = hdr->count;
+    offsets = reinterpret_cast<const std::uint64_t*>(hdr + 1);
+    chars = reinterpret_cast<const char*>(offsets + n + 1);
+    nchars = hdr->chars;
+    // only the ends are checked so that opening stays O(1); operator[] checks the rest
+    if (offsets[0] != 0 || offsets[n] != hdr->chars) {
+        munmap(base, length);
+        base = nullptr;
+        throw std::runtime_error("corrupt StrVec file: " + path);
+    }
+}
+
+inline StrVec StrVecView::to_strvec() const
+{
+    StrVec ret;
+    for (auto s : *this)
+        ret.push_back(std::string(s));
+    return ret;
+}
+
+#endif
@@ -0,0 +1,105 @@
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+#include <bits/stdc++.h>
+
+// fixed set of worker threads that run queued tasks
+// the threads are started once and reused, so a parallel step costs a few queue
+// operations instead of creating and joining threads
+class ThreadPool {
+public:
+    explicit ThreadPool(unsigned threads = 0); // 0: one per core
+    ~ThreadPool();
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool &operator=(const ThreadPool&) = delete;
+
+    unsigned size() const { return static_cast<unsigned>(workers.size()); }
+    // runs f(i) for every i in [0, n) on the workers and the calling thread, and returns
+    // when all calls are done; if any call throws, the first exception is rethrown here
+    template <typename F> void parallel_for(std::size_t n, F f);
+private:
+    void submit(std::function<void()> task);
+
+    std::vector<std::thread> workers;
+    std::deque<std::function<void()>> tasks;
+    std::mutex m;
+    std::condition_variable ready;
+    bool stopping = false;
+};
+
+inline ThreadPool::ThreadPool(unsigned threads)
+{
+    if (threads == 0)
+        threads = std::max(1u, std::thread::hardware_concurrency());
+    for (unsigned t = 0; t != threads; ++t)
+        workers.emplace_back([this] {
+            for (;;) {
+                std::function<void()> task;
+                {
+                    std::unique_lock<std::mutex> lock(m);
+                    ready.wait(lock, [this] { return stopping || !tasks.empty(); });
+                    if (tasks.empty())
+                        return; // stopping, and nothing left to do
+                    task = std::move(tasks.front());
+                    tasks.pop_front();
+                }
+                task();
+            }
+        });
+}
+
+inline ThreadPool::~ThreadPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(m);
+        stopping = true;
+    }
+    ready.notify_all();
+    for (auto &w : workers)
+        w.join();
+}
+
+inline void ThreadPool::submit(std::function<void()> task)
+{
+    {
+        std::lock_guard<std::mutex> lock(m);
+        tasks.push_back(std::move(task));
+    }
+    ready.notify_one();
+}
+
+template <typename F> void ThreadPool::parallel_for(std::size_t n, F f)
+{
+    // every participant takes the next index until none are left
+    std::atomic<std::size_t> next{0};
+    std::exception_ptr error;
+    std::mutex done_m;
+    std::condition_variable done_cv;
+    std::size_t helpers = std::min<std::size_t>(size(), n ? n - 1 : 0), finished = 0;
+    auto run = [&] {
+        try {
+            for (auto i = next++; i < n; i = next++)
+                f(i);
+        } catch (...) {
+            next = n; // the others stop at their next index
+            std::lock_guard<std::mutex> lock(done_m);
+            if (!error)
+                error = std::current_exception();
+        }
+    };
+    for (std::size_t h = 0; h != helpers; ++h)
+        submit([&] {
+            run();
+            std::lock_guard<std::mutex> lock(done_m);
+            if (++finished == helpers)
+                done_cv.notify_one();
+        });
+    run();
+    // the helpers use this frame, so wait for all of them, even those that found no work
+    std::unique_lock<std::mutex> lock(done_m);
+    done_cv.wait(lock, [&] { return finished == helpers; });
+    if (error)
+        std::rethrow_exception(error);
+}
+
+#endif
@@ -0,0 +1,53 @@
+#include "vec.h"
+
+using namespace std;
+
+#if defined(__cpp_constexpr_dynamic_alloc) && __cpp_constexpr_dynamic_alloc >= 201907L
+// with C++20 the whole Vec can be used inside a constant expression
+constexpr int sum_of_squares(int n)
+{
+    Vec<int> v;
+    for (int i = 1; i <= n; ++i)
+        v.push_back(i * i);
+    int sum = 0;
+    for (auto p = v.begin(); p != v.end(); ++p)
+        sum += *p;
+    return sum;
+}
+static_assert(sum_of_squares(4) == 30, "constexpr Vec");
+#endif
+
+int main() {
+    Vec<string> svec; // same behavior as StrVec
+    svec.push_back("abc");
+    cout << svec.capacity() << endl;
+    svec.push_back("def");
+    cout << svec.capacity() << endl;
+    svec.push_back("ghi");
+    cout << svec.capacity() << endl;
+    for (auto p = svec.begin(); p != svec.end(); ++p) {
+        cout << *p << endl;
+    }
+
+    Vec<int> ivec; // trivially copyable: grows with memcpy, no destructor loop
+    for (int i = 0; i != 10; ++i)
+        ivec.push_back(i);
+    Vec<int> icopy = ivec;
+    for (auto i : icopy)
+        cout << i << " ";
+    cout << endl;
+
+    // erase/insert shift the tail; erase_if compacts in a single pass
+    svec.erase(svec.begin());
+    svec.insert(svec.begin() + 1, "xyz");
+    svec.pop_back();
+    ivec.erase_if([](int i) { return i % 3 == 0; });
+    ivec.insert(ivec.begin(), 42);
+    for (auto &s : svec)
+        cout << s << " ";
+    cout << endl;
+    for (auto i : ivec)
+        cout << i << " ";
+    cout << endl;
+    return 0;
+}
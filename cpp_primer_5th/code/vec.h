@@ -0,0 +1,466 @@
+#ifndef VEC_H
+#define VEC_H
+
+#include <bits/stdc++.h>
+
+// allocations inside constant expressions need C++20 (P0784)
+#if defined(__cpp_constexpr_dynamic_alloc) && __cpp_constexpr_dynamic_alloc >= 201907L
+#define VEC_CONSTEXPR constexpr
+#else
+#define VEC_CONSTEXPR
+#endif
+
+// true while the compiler evaluates a constant expression;
+// memcpy/memmove are not usable there, so we fall back to the element-wise path
+constexpr bool vec_constant_evaluated() noexcept
+{
+#if defined(__cpp_lib_is_constant_evaluated)
+    return std::is_constant_evaluated();
+#else
+    return false;
+#endif
+}
+
+// allocation counters shared by every Vec; compile with -DVEC_STATS to turn them on,
+// the totals are then written to cerr when the program exits
+struct VecStats {
+    std::uint64_t allocations = 0; // blocks obtained from the allocator
+    std::uint64_t deallocations = 0; // blocks given back
+    std::uint64_t bytes_allocated = 0; // sum of the sizes of all allocated blocks
+    std::uint64_t reallocations = 0; // growths caused by adding elements
+    std::uint64_t elements_moved = 0; // elements relocated by those growths
+    std::uint64_t bytes_moved = 0; // sizeof(T) * elements_moved
+    std::uint64_t peak_capacity_bytes = 0; // largest block ever allocated
+    std::uint64_t slack_bytes = 0; // unused capacity, summed as each block is freed
+};
+
+inline std::ostream &operator<<(std::ostream &os, const VecStats &st)
+{
+    return os << "allocations: " << st.allocations
+              << " deallocations: " << st.deallocations
+              << " bytes allocated: " << st.bytes_allocated
+              << " reallocations: " << st.reallocations
+              << " elements moved: " << st.elements_moved
+              << " bytes moved: " << st.bytes_moved
+              << " peak capacity (bytes): " << st.peak_capacity_bytes
+              << " slack (bytes): " << st.slack_bytes << '\n';
+}
+
+struct VecCounters {
+    std::atomic<std::uint64_t> allocations{0}, deallocations{0}, bytes_allocated{0},
+        reallocations{0}, elements_moved{0}, bytes_moved{0},
+        peak_capacity_bytes{0}, slack_bytes{0};
+};
+inline VecCounters vec_counters;
+
+// snapshot of the counters; all zero unless VEC_STATS is defined
+inline VecStats vec_stats()
+{
+    auto &c = vec_counters;
+    return {c.allocations.load(), c.deallocations.load(), c.bytes_allocated.load(),
+            c.reallocations.load(), c.elements_moved.load(), c.bytes_moved.load(),
+            c.peak_capacity_bytes.load(), c.slack_bytes.load()};
+}
+
+inline void vec_reset_stats()
+{
+    auto &c = vec_counters;
+    for (auto p : {&c.allocations, &c.deallocations, &c.bytes_allocated, &c.reallocations,
+                   &c.elements_moved, &c.bytes_moved, &c.peak_capacity_bytes, &c.slack_bytes})
+        p->store(0);
+}
+
+// hooks called by Vec; they compile to nothing without VEC_STATS
+inline void vec_note_alloc(std::size_t bytes)
+{
+#ifdef VEC_STATS
+    auto &c = vec_counters;
+    c.allocations.fetch_add(1, std::memory_order_relaxed);
+    c.bytes_allocated.fetch_add(bytes, std::memory_order_relaxed);
+    auto peak = c.peak_capacity_bytes.load(std::memory_order_relaxed);
+    while (peak < bytes &&
+           !c.peak_capacity_bytes.compare_exchange_weak(peak, bytes, std::memory_order_relaxed))
+        ;
+#else
+    (void)bytes;
+#endif
+}
+
+inline void vec_note_free(std::size_t slack)
+{
+#ifdef VEC_STATS
+    vec_counters.deallocations.fetch_add(1, std::memory_order_relaxed);
+    vec_counters.slack_bytes.fetch_add(slack, std::memory_order_relaxed);
+#else
+    (void)slack;
+#endif
+}
+
+inline void vec_note_move(std::size_t elems, std::size_t bytes)
+{
+#ifdef VEC_STATS
+    vec_counters.reallocations.fetch_add(1, std::memory_order_relaxed);
+    vec_counters.elements_moved.fetch_add(elems, std::memory_order_relaxed);
+    vec_counters.bytes_moved.fetch_add(bytes, std::memory_order_relaxed);
+#else
+    (void)elems; (void)bytes;
+#endif
+}
+
+#ifdef VEC_STATS
+// prints the totals when static objects are destroyed at exit
+struct VecStatsDumper {
+    ~VecStatsDumper() { std::cerr << "Vec stats: " << vec_stats(); }
+};
+inline VecStatsDumper vec_stats_dumper;
+#endif
+
+// detects an allocator that can grow a block in place, see hugepage_allocator.h
+template <typename A, typename = void>
+struct alloc_has_reallocate: std::false_type { };
+template <typename A>
+struct alloc_has_reallocate<A, std::void_t<decltype(std::declval<A&>().reallocate(
+        std::declval<typename A::value_type*>(), std::size_t(), std::size_t()))>>:
+    std::true_type { };
+
+// StrVec generalized to any element type; same allocation strategy and growth policy
+// Alloc supplies the memory; see hugepage_allocator.h for an alternative to std::allocator
+template <typename T, typename Alloc = std::allocator<T>> class Vec {
+public:
+    using value_type = T;
+    using size_type = std::size_t;
+
+    VEC_CONSTEXPR Vec() noexcept: // the allocator member is default initialized
+        elements(nullptr), first_free(nullptr), cap(nullptr) {
+    }
+    VEC_CONSTEXPR Vec(std::initializer_list<T>);
+    VEC_CONSTEXPR Vec(const Vec&); // copy constructor
+    VEC_CONSTEXPR Vec(Vec&&) noexcept; // move constructor
+    VEC_CONSTEXPR Vec &operator=(const Vec&); // copy assignment
+    VEC_CONSTEXPR Vec &operator=(Vec&&) noexcept; // move assignment
+    VEC_CONSTEXPR ~Vec(); // destructor
+    VEC_CONSTEXPR void push_back(const T&); // copy the element
+    VEC_CONSTEXPR void push_back(T&&); // move the element
+    // construct an element in place from args
+    template <typename... Args> VEC_CONSTEXPR T &emplace_back(Args&&... args);
+    VEC_CONSTEXPR void pop_back(); // destroy the last element
+    VEC_CONSTEXPR void reserve(size_type n) { if (n > capacity()) reallocate(n); }
+    // insert before pos; returns an iterator to the new element
+    VEC_CONSTEXPR T *insert(T *pos, const T&);
+    VEC_CONSTEXPR T *insert(T *pos, T&&);
+    // remove elements; returns an iterator to the element after the last one removed
+    VEC_CONSTEXPR T *erase(T *pos) { return erase(pos, pos + 1); }
+    VEC_CONSTEXPR T *erase(T *b, T *e);
+    // remove every element for which pred is true, keeping the order of the others
+    template <typename Pred> VEC_CONSTEXPR size_type erase_if(Pred pred);
+    VEC_CONSTEXPR size_type size() const { return first_free - elements; }
+    VEC_CONSTEXPR size_type capacity() const { return cap - elements; }
+    VEC_CONSTEXPR bool empty() const { return first_free == elements; }
+    VEC_CONSTEXPR T *begin() const { return elements; }
+    VEC_CONSTEXPR T *end() const { return first_free; }
+    VEC_CONSTEXPR T &operator[](size_type n) const { return elements[n]; }
+private:
+    using traits = std::allocator_traits<Alloc>;
+    // element types whose bytes can be copied and whose destructors do nothing
+    static constexpr bool trivial_copy = std::is_trivially_copyable<T>::value;
+    static constexpr bool trivial_destroy = std::is_trivially_destructible<T>::value;
+
+    Alloc alloc; // allocates the elements
+    // used by the functions that add elements to the Vec
+    VEC_CONSTEXPR void chk_n_alloc() {
+        if (size() == capacity()) reallocate();
+    }
+    // utilities used by the copy constructor, assignment operator, and destructor
+    // 分配内存，拷贝给定范围中的元素
+    VEC_CONSTEXPR std::pair<T*, T*> alloc_n_copy(const T*, const T*);
+    VEC_CONSTEXPR void free(); // destroy the elements and free the space
+    // get more space and move the existing elements; by default the size doubles
+    VEC_CONSTEXPR void reallocate() { reallocate(size() ? 2 * size() : 1); }
+    VEC_CONSTEXPR void reallocate(size_type newcapacity);
+    VEC_CONSTEXPR void destroy(T *b, T *e); // destroy the elements in [b, e)
+
+    T *elements; // pointer to the first element in the array
+    T *first_free; // pointer to the first free element in the array
+    T *cap; // pointer to one past the end of the array
+};
+
+template <typename T, typename Alloc>
+VEC_CONSTEXPR void Vec<T, Alloc>::push_back(const T &t)
+{
+    if (size() == capacity()) {
+        // t may refer to an element of this Vec, which reallocate frees: copy it first
+        T copy(t);
+        reallocate();
+        traits::construct(alloc, first_free++, std::move(copy));
+        return;
+    }
+    // construct a copy of t in the element to which first_free points
+    traits::construct(alloc, first_free++, t);
+}
+
+template <typename T, typename Alloc>
+VEC_CONSTEXPR void Vec<T, Alloc>::push_back(T &&t)
+{
+    chk_n_alloc();
+    traits::construct(alloc, first_free++, std::move(t));
+}
+
+template <typename T, typename Alloc>
+template <typename... Args>
+VEC_CONSTEXPR T &Vec<T, Alloc>::emplace_back(Args&&... args)
+{
+    if (size() == capacity()) {
+        // args may refer to elements of this Vec; build the new one before they go away
+        T t(std::forward<Args>(args)...);
+        reallocate();
+        traits::construct(alloc, first_free, std::move(t));
+        return *first_free++;
+    }
+    traits::construct(alloc, first_free, std::forward<Args>(args)...);
+    return *first_free++;
+}
+
+template <typename T, typename Alloc>
+VEC_CONSTEXPR std::pair<T*, T*>
+Vec<T, Alloc>::alloc_n_copy(const T *b, const T *e)
+{
+    // allocate space to hold as many elements as are in the range
+    auto data = alloc.allocate(e - b);
+    if (!vec_constant_evaluated())
+        vec_note_alloc((e - b) * sizeof(T));
+    if constexpr (trivial_copy) {
+        if (!vec_constant_evaluated()) {
+            // copying the bytes is the copy; b may be null for an empty range
+            if (b != e)
+                std::memcpy(data, b, (e - b) * sizeof(T));
+            return {data, data + (e - b)};
+        }
+    }
+    if (vec_constant_evaluated()) {
+        // uninitialized_copy is not usable in constant expressions
+        auto dest = data;
+        for (auto p = b; p != e; ++p)
+            traits::construct(alloc, dest++, *p);
+        return {data, dest};
+    }
+    return {data, std::uninitialized_copy(b, e, data)};
+}
+
+template <typename T, typename Alloc>
+VEC_CONSTEXPR void Vec<T, Alloc>::free()
+{
+    // may not pass deallocate a 0 pointer; if elements is 0, there's no work to do
+    if (elements) {
+        if (!vec_constant_evaluated())
+            vec_note_free((cap - first_free) * sizeof(T));
+        // destroy the old elements in reverse order; nothing to run for trivial destructors
+        if constexpr (!trivial_destroy)
+            for (auto p = first_free; p != elements; /* empty */)
+                traits::destroy(alloc, --p);
+        alloc.deallocate(elements, cap - elements);
+    }
+}
+
+template <typename T, typename Alloc>
+VEC_CONSTEXPR Vec<T, Alloc>::Vec(std::initializer_list<T> il)
+{
+    auto newdata = alloc_n_copy(il.begin(), il.end());
+    elements = newdata.first;
+    first_free = cap = newdata.second;
+}
+
+template <typename T, typename Alloc>
+VEC_CONSTEXPR Vec<T, Alloc>::Vec(const Vec &s)
+{
+    // call alloc_n_copy to allocate exactly as many elements as in s
+    auto newdata = alloc_n_copy(s.begin(), s.end());
+    elements = newdata.first;
+    first_free = cap = newdata.second;
+}
+
+template <typename T, typename Alloc>
+VEC_CONSTEXPR Vec<T, Alloc>::Vec(Vec &&s) noexcept:
+    elements(s.elements), first_free(s.first_free), cap(s.cap)
+{
+    // leave s in a state in which it is safe to run the destructor
+    s.elements = s.first_free = s.cap = nullptr;
+}
+
+template <typename T, typename Alloc>
+VEC_CONSTEXPR Vec<T, Alloc>::~Vec() { free(); }
+
+template <typename T, typename Alloc>
+VEC_CONSTEXPR Vec<T, Alloc> &Vec<T, Alloc>::operator=(const Vec &rhs)
+{
+    // call alloc_n_copy to allocate exactly as many elements as in rhs
+    auto data = alloc_n_copy(rhs.begin(), rhs.end());
+    free();
+    elements = data.first;
+    first_free = cap = data.second;
+    return *this;
+}
+
+template <typename T, typename Alloc>
+VEC_CONSTEXPR Vec<T, Alloc> &Vec<T, Alloc>::operator=(Vec &&rhs) noexcept
+{
+    // direct test for self-assignment
+    if (this != &rhs) {
+        free(); // free existing elements
+        elements = rhs.elements; // take over resources from rhs
+        first_free = rhs.first_free;
+        cap = rhs.cap;
+        // leave rhs in a destructible state
+        rhs.elements = rhs.first_free = rhs.cap = nullptr;
+    }
+    return *this;
+}
+
+template <typename T, typename Alloc>
+VEC_CONSTEXPR void Vec<T, Alloc>::reallocate(size_type newcapacity)
+{
+    if constexpr (trivial_copy && alloc_has_reallocate<Alloc>::value) {
+        // the allocator may be able to grow the block without copying the elements
+        if (elements && !vec_constant_evaluated()) {
+            auto sz = size();
+            if (auto p = alloc.reallocate(elements, capacity(), newcapacity)) {
+                vec_note_alloc(newcapacity * sizeof(T));
+                vec_note_free(0);
+                vec_note_move(0, 0);
+                elements = p;
+                first_free = p + sz;
+                cap = p + newcapacity;
+                return;
+            }
+        }
+    }
+    // allocate new memory
+    auto newdata = alloc.allocate(newcapacity);
+    if (!vec_constant_evaluated()) {
+        vec_note_alloc(newcapacity * sizeof(T));
+        vec_note_move(size(), size() * sizeof(T));
+    }
+    auto dest = newdata; // points to the next free position in the new array
+    if constexpr (trivial_copy) {
+        if (!vec_constant_evaluated()) {
+            // the old and new blocks never overlap, so a single memcpy relocates everything
+            if (elements)
+                std::memcpy(newdata, elements, size() * sizeof(T));
+            dest = newdata + size();
+        }
+    }
+    if (dest == newdata) {
+        // move the data from the old memory to the new
+        // move_if_noexcept moves only if that cannot throw (or T cannot be copied);
+        // otherwise it copies, so a failure leaves the old elements untouched
+        auto elem = elements; // points to the next element in the old array
+        try {
+            for (size_type i = 0; i != size(); ++i)
+                traits::construct(alloc, dest++, std::move_if_noexcept(*elem++));
+        } catch (...) {
+            // a copy threw: undo the new array and leave the Vec as it was
+            destroy(newdata, dest - 1);
+            alloc.deallocate(newdata, newcapacity);
+            throw;
+        }
+    }
+    free(); // free the old space once we've moved the elements
+    // update our data structure to point to the new elements
+    elements = newdata;
+    first_free = dest;
+    cap = elements + newcapacity;
+}
+
+template <typename T, typename Alloc>
+VEC_CONSTEXPR void Vec<T, Alloc>::destroy(T *b, T *e)
+{
+    if constexpr (!trivial_destroy)
+        while (e != b)
+            traits::destroy(alloc, --e);
+}
+
+template <typename T, typename Alloc>
+VEC_CONSTEXPR void Vec<T, Alloc>::pop_back()
+{
+    --first_free;
+    destroy(first_free, first_free + 1);
+}
+
+template <typename T, typename Alloc>
+VEC_CONSTEXPR T *Vec<T, Alloc>::erase(T *b, T *e)
+{
+    if (b == e)
+        return b;
+    if constexpr (trivial_copy) {
+        if (!vec_constant_evaluated()) {
+            // slide the tail down over the hole in one go
+            std::memmove(b, e, (first_free - e) * sizeof(T));
+            first_free -= e - b;
+            return b;
+        }
+    }
+    // move the tail down, then destroy the moved-from elements left at the end
+    auto new_end = std::move(e, first_free, b);
+    destroy(new_end, first_free);
+    first_free = new_end;
+    return b;
+}
+
+template <typename T, typename Alloc>
+VEC_CONSTEXPR T *Vec<T, Alloc>::insert(T *pos, const T &t)
+{
+    // t may refer to an element of this Vec, which the shift below would overwrite
+    T copy(t);
+    return insert(pos, std::move(copy));
+}
+
+template <typename T, typename Alloc>
+VEC_CONSTEXPR T *Vec<T, Alloc>::insert(T *pos, T &&t)
+{
+    // reallocation invalidates pos, so remember it as an index
+    auto i = pos - elements;
+    chk_n_alloc();
+    pos = elements + i;
+    if (pos == first_free) {
+        traits::construct(alloc, first_free++, std::move(t));
+        return pos;
+    }
+    if constexpr (trivial_copy) {
+        if (!vec_constant_evaluated()) {
+            // open the gap by sliding the tail up one slot, then drop t into it
+            std::memmove(pos + 1, pos, (first_free - pos) * sizeof(T));
+            ++first_free;
+            std::memcpy(pos, &t, sizeof(T));
+            return pos;
+        }
+    }
+    // the last element moves into the unconstructed slot, the rest shift by assignment
+    traits::construct(alloc, first_free, std::move(first_free[-1]));
+    ++first_free;
+    std::move_backward(pos, first_free - 2, first_free - 1);
+    *pos = std::move(t);
+    return pos;
+}
+
+template <typename T, typename Alloc>
+template <typename Pred>
+VEC_CONSTEXPR typename Vec<T, Alloc>::size_type Vec<T, Alloc>::erase_if(Pred pred)
+{
+    // single pass: every kept element moves down at most once
+    auto dest = elements;
+    for (auto p = elements; p != first_free; ++p) {
+        if (pred(*p))
+            continue;
+        if (dest != p)
+            *dest = std::move(*p);
+        ++dest;
+    }
+    auto removed = first_free - dest;
+    destroy(dest, first_free);
+    first_free = dest;
+    return removed;
+}
+
+// the original StrVec is simply a Vec of strings
+using StrVec = Vec<std::string>;
+
+#endif